@@ -0,0 +1,130 @@
+#include "MicroBench.hpp"
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+
+namespace microbench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+double timeBatch(const std::function<void()>& body, long iterations) {
+    auto start = Clock::now();
+    for (long i = 0; i < iterations; i++) {
+        body();
+    }
+    return elapsedNs(start);
+}
+
+// Value of `"key": ` on a line written by writeJson
+bool findField(const std::string& line, const std::string& key, std::string& value) {
+    std::string marker = "\"" + key + "\": ";
+    size_t pos = line.find(marker);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos += marker.size();
+    if (pos < line.size() && line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        if (end == std::string::npos) {
+            return false;
+        }
+        value = line.substr(pos + 1, end - pos - 1);
+    } else {
+        size_t end = line.find_first_of(",}", pos);
+        value = line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+    return true;
+}
+
+} // namespace
+
+std::string Result::key() const {
+    return name + "/" + std::to_string(size);
+}
+
+Result run(const std::string& name, int size, const std::function<void()>& body, const Settings& settings) {
+    // Warm caches and branch predictors, doubling the batch until the warmup time is used
+    long iterations = 1;
+    double warmupNs = settings.warmupMs * 1e6;
+    double spentNs = 0.0;
+    double lastBatchNs = 0.0;
+    while (spentNs < warmupNs) {
+        lastBatchNs = timeBatch(body, iterations);
+        spentNs += lastBatchNs;
+        if (spentNs < warmupNs) {
+            iterations *= 2;
+        }
+    }
+
+    // Scale the batch so a sample takes roughly sampleMs
+    double perCallNs = std::max(lastBatchNs / iterations, 1.0);
+    iterations = std::max(1L, static_cast<long>(settings.sampleMs * 1e6 / perCallNs));
+
+    std::vector<double> samples;
+    for (int s = 0; s < std::max(1, settings.samples); s++) {
+        samples.push_back(timeBatch(body, iterations) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = name;
+    result.size = size;
+    result.iterations = iterations;
+    result.samples = static_cast<int>(samples.size());
+    result.minNs = samples.front();
+    size_t mid = samples.size() / 2;
+    result.medianNs = samples.size() % 2 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2.0;
+    result.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    double variance = 0.0;
+    for (double sample : samples) {
+        variance += (sample - result.meanNs) * (sample - result.meanNs);
+    }
+    result.stddevNs = samples.size() > 1 ? std::sqrt(variance / (samples.size() - 1)) : 0.0;
+    result.p90Ns = samples[std::min(samples.size() - 1, static_cast<size_t>(std::ceil(samples.size() * 0.9)) - 1)];
+    return result;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results) {
+    // One benchmark per line keeps readBaseline trivial and diffs readable
+    char numbers[256];
+    out << "{\"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        std::snprintf(numbers, sizeof(numbers),
+                      "\"min_ns\": %.2f, \"median_ns\": %.2f, \"mean_ns\": %.2f, \"stddev_ns\": %.2f, \"p90_ns\": %.2f",
+                      r.minNs, r.medianNs, r.meanNs, r.stddevNs, r.p90Ns);
+        out << "  {\"name\": \"" << r.name << "\", \"size\": " << r.size
+            << ", \"iterations\": " << r.iterations << ", \"samples\": " << r.samples
+            << ", " << numbers << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]}\n";
+}
+
+bool readBaseline(const std::string& path, std::map<std::string, double>& medians) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::string name, size, median;
+        if (findField(line, "name", name) && findField(line, "size", size) &&
+            findField(line, "median_ns", median)) {
+            medians[name + "/" + size] = std::atof(median.c_str());
+        }
+    }
+    return true;
+}
+
+} // namespace microbench
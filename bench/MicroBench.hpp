@@ -0,0 +1,55 @@
+#ifndef MICRO_BENCH_HPP
+#define MICRO_BENCH_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <ostream>
+
+// Minimal micro-benchmark harness: warm up, calibrate how many calls fill one
+// sample, take several samples and summarize the time per call.
+namespace microbench {
+
+// Keeps the compiler from optimizing a computed value away
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Settings {
+    int samples = 15;            // Timed samples per benchmark
+    double warmupMs = 20.0;      // Untimed calls before calibrating
+    double sampleMs = 5.0;       // Target duration of one sample
+};
+
+struct Result {
+    std::string name;
+    int size = 0;
+    long iterations = 0;         // Calls per sample
+    int samples = 0;
+    double minNs = 0.0;          // All statistics are nanoseconds per call
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    double stddevNs = 0.0;
+    double p90Ns = 0.0;
+
+    std::string key() const;     // "name/size", used to match baselines
+};
+
+// Time one call of `body` (it is called many times)
+Result run(const std::string& name, int size, const std::function<void()>& body, const Settings& settings);
+
+void writeJson(std::ostream& out, const std::vector<Result>& results);
+
+// Reads median times back from a file written by writeJson, keyed by Result::key()
+bool readBaseline(const std::string& path, std::map<std::string, double>& medians);
+
+} // namespace microbench
+
+#endif // MICRO_BENCH_HPP
@@ -0,0 +1,277 @@
+// End-to-end solver benchmark: generates seeded instances of increasing size,
+// times every solver mode on them and prints one record per (size, mode).
+//
+//   ./scheduler_bench [--sizes 5,10,20] [--modes enumerate,local,sat,incremental]
+//                     [--repeat 3] [--seed 1] [--budget-ms 5000] [--format json|csv]
+//
+// "incremental" solves each instance once with local search, then times
+// resolveAfterEdits after adding one section per repeat.
+#include "Scheduler.hpp"
+#include "InstanceGenerator.hpp"
+#include "Log.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+
+struct BenchConfig {
+    std::vector<int> sizes = { 5, 10, 20 };
+    std::vector<SolverMode> modes = { SolverMode::ENUMERATE, SolverMode::LOCAL_SEARCH, SolverMode::SAT };
+    bool incremental = false;
+    int repeat = 3;
+    uint32_t seed = 1;
+    int budgetMs = 5000;
+    bool csv = false;
+};
+
+struct BenchResult {
+    int courses = 0;
+    size_t sections = 0;
+    size_t pinned = 0;
+    std::string mode;
+    std::vector<double> runsMs;
+    bool found = false;
+    std::string status;
+    long candidatesTried = 0;
+    long validFound = 0;
+    double bestScore = 0.0;
+};
+
+const char* modeName(SolverMode mode) {
+    switch (mode) {
+        case SolverMode::LOCAL_SEARCH: return "local";
+        case SolverMode::SAT:          return "sat";
+        default:                       return "enumerate";
+    }
+}
+
+const char* statusName(SolveStatus status) {
+    switch (status) {
+        case SolveStatus::TIMED_OUT:     return "timed_out";
+        case SolveStatus::CANCELLED:     return "cancelled";
+        case SolveStatus::LIMIT_REACHED: return "limit_reached";
+        default:                         return "completed";
+    }
+}
+
+bool parseMode(const std::string& name, SolverMode& mode) {
+    if (name == "enumerate") { mode = SolverMode::ENUMERATE; return true; }
+    if (name == "local")     { mode = SolverMode::LOCAL_SEARCH; return true; }
+    if (name == "sat")       { mode = SolverMode::SAT; return true; }
+    return false;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--sizes") {
+            config.sizes.clear();
+            for (const auto& part : splitList(value)) {
+                config.sizes.push_back(std::atoi(part.c_str()));
+            }
+        } else if (arg == "--modes") {
+            config.modes.clear();
+            config.incremental = false;
+            for (const auto& part : splitList(value)) {
+                SolverMode mode;
+                if (part == "incremental") {
+                    config.incremental = true;
+                    continue;
+                }
+                if (!parseMode(part, mode)) {
+                    std::cerr << "Unknown mode " << part << " (enumerate, local, sat, incremental)" << std::endl;
+                    return false;
+                }
+                config.modes.push_back(mode);
+            }
+        } else if (arg == "--repeat") {
+            config.repeat = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--seed") {
+            config.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--budget-ms") {
+            config.budgetMs = std::atoi(value.c_str());
+        } else if (arg == "--format") {
+            config.csv = value == "csv";
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+BenchResult runOne(const BenchConfig& config, int size, SolverMode mode) {
+    InstanceOptions instance;
+    instance.courses = size;
+    instance.teachers = std::max(2, size / 2);
+    instance.seed = config.seed;
+
+    Scheduler scheduler;
+    InstanceGenerator generator(instance);
+    generator.populate(scheduler);
+    scheduler.setSolveCacheCapacity(0);  // Every repeat must really solve
+
+    SolveOptions options;
+    options.mode = mode;
+    options.timeBudgetMs = config.budgetMs;
+    options.localSearch.seed = config.seed;  // Fixed seed keeps runs comparable
+
+    BenchResult result;
+    result.courses = size;
+    result.sections = scheduler.getSections().size();
+    result.pinned = scheduler.getRequirements().size();
+    result.mode = modeName(mode);
+
+    for (int run = 0; run < config.repeat; run++) {
+        auto start = std::chrono::steady_clock::now();
+        result.found = scheduler.generateSchedule(options);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        result.runsMs.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+
+    const SolveProgress& progress = scheduler.getLastSolveProgress();
+    result.status = statusName(scheduler.getLastSolveStatus());
+    result.candidatesTried = progress.candidatesTried;
+    result.validFound = progress.validFound;
+    result.bestScore = progress.hasBest ? progress.bestScore : 0.0;
+    return result;
+}
+
+// Times the re-solve after one added section, starting from a solved term
+BenchResult runIncremental(const BenchConfig& config, int size) {
+    InstanceOptions instance;
+    instance.courses = size;
+    instance.teachers = std::max(2, size / 2);
+    instance.seed = config.seed;
+
+    Scheduler scheduler;
+    InstanceGenerator generator(instance);
+    generator.populate(scheduler);
+    scheduler.setSolveCacheCapacity(0);
+
+    SolveOptions options;
+    options.mode = SolverMode::LOCAL_SEARCH;
+    options.timeBudgetMs = config.budgetMs;
+    options.localSearch.seed = config.seed;
+
+    BenchResult result;
+    result.courses = size;
+    result.pinned = scheduler.getRequirements().size();
+    result.mode = "incremental";
+    result.found = scheduler.generateSchedule(options);
+
+    for (int run = 0; run < config.repeat && result.found; run++) {
+        const auto& courses = scheduler.getCourses();
+        const auto& teachers = scheduler.getTeachers();
+        auto course = courses[run % courses.size()];
+        auto teacher = teachers[run % teachers.size()];
+        scheduler.addSection(makeRef<Section>("BENCH-" + std::to_string(run), course, teacher, TimeSlot(60)));
+
+        auto start = std::chrono::steady_clock::now();
+        result.found = scheduler.resolveAfterEdits(options);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        result.runsMs.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+    if (result.runsMs.empty()) {
+        result.runsMs.push_back(0.0);  // The initial solve failed, there was nothing to repair
+    }
+
+    result.sections = scheduler.getSections().size();
+    const SolveProgress& progress = scheduler.getLastSolveProgress();
+    result.status = statusName(scheduler.getLastSolveStatus());
+    result.candidatesTried = progress.candidatesTried;
+    result.validFound = progress.validFound;
+    result.bestScore = progress.hasBest ? progress.bestScore : 0.0;
+    return result;
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+void printCsvHeader() {
+    std::cout << "courses,sections,pinned,mode,runs,min_ms,median_ms,max_ms,found,status,"
+                 "candidates_tried,valid_found,best_score\n";
+}
+
+void printCsv(const BenchResult& r) {
+    auto range = std::minmax_element(r.runsMs.begin(), r.runsMs.end());
+    std::cout << r.courses << "," << r.sections << "," << r.pinned << "," << r.mode << ","
+              << r.runsMs.size() << "," << *range.first << "," << median(r.runsMs) << ","
+              << *range.second << "," << (r.found ? 1 : 0) << "," << r.status << ","
+              << r.candidatesTried << "," << r.validFound << "," << r.bestScore << "\n";
+}
+
+void printJson(const BenchResult& r, bool last) {
+    auto range = std::minmax_element(r.runsMs.begin(), r.runsMs.end());
+    std::cout << "  {\"courses\": " << r.courses << ", \"sections\": " << r.sections
+              << ", \"pinned\": " << r.pinned << ", \"mode\": \"" << r.mode << "\""
+              << ", \"runs\": " << r.runsMs.size() << ", \"min_ms\": " << *range.first
+              << ", \"median_ms\": " << median(r.runsMs) << ", \"max_ms\": " << *range.second
+              << ", \"found\": " << (r.found ? "true" : "false") << ", \"status\": \"" << r.status << "\""
+              << ", \"candidates_tried\": " << r.candidatesTried << ", \"valid_found\": " << r.validFound
+              << ", \"best_score\": " << r.bestScore << "}" << (last ? "\n" : ",\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        return 2;
+    }
+
+    // Solver chatter would only distort the timings
+    Logger::setLevel(LogLevel::WARN);
+
+    std::vector<BenchResult> results;
+    for (int size : config.sizes) {
+        for (SolverMode mode : config.modes) {
+            std::cerr << "Running " << modeName(mode) << " on " << size << " courses..." << std::endl;
+            results.push_back(runOne(config, size, mode));
+        }
+        if (config.incremental) {
+            std::cerr << "Running incremental on " << size << " courses..." << std::endl;
+            results.push_back(runIncremental(config, size));
+        }
+    }
+
+    if (config.csv) {
+        printCsvHeader();
+        for (const auto& result : results) {
+            printCsv(result);
+        }
+    } else {
+        std::cout << "[\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            printJson(results[i], i + 1 == results.size());
+        }
+        std::cout << "]\n";
+    }
+    return 0;
+}
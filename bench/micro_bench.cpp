@@ -0,0 +1,245 @@
+// Micro-benchmarks for the model and PQ-tree primitives the solver leans on.
+//
+//   ./scheduler_microbench [--sizes 10,50,200] [--filter hasConflicts]
+//                          [--samples 15] [--warmup-ms 20] [--sample-ms 5]
+//                          [--output results.json]
+//                          [--baseline baseline.json] [--threshold 10]
+//                          [--threshold-for Schedule::hasConflicts=25]
+//
+// Record a baseline with --output, then pass it back with --baseline: any
+// benchmark whose median is more than its threshold (percent) slower fails
+// the run with exit code 1.
+#include "MicroBench.hpp"
+#include "Scheduler.hpp"
+#include "PQTree.hpp"
+#include "Log.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+
+namespace {
+
+struct Config {
+    std::vector<int> sizes = { 10, 50, 200 };
+    std::string filter;
+    microbench::Settings settings;
+    std::string outputPath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+    std::map<std::string, double> thresholdFor;  // By benchmark name
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+bool parseArgs(int argc, char** argv, Config& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--sizes") {
+            config.sizes.clear();
+            for (const auto& part : splitList(value)) {
+                config.sizes.push_back(std::max(1, std::atoi(part.c_str())));
+            }
+        } else if (arg == "--filter") {
+            config.filter = value;
+        } else if (arg == "--samples") {
+            config.settings.samples = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--warmup-ms") {
+            config.settings.warmupMs = std::atof(value.c_str());
+        } else if (arg == "--sample-ms") {
+            config.settings.sampleMs = std::atof(value.c_str());
+        } else if (arg == "--output") {
+            config.outputPath = value;
+        } else if (arg == "--baseline") {
+            config.baselinePath = value;
+        } else if (arg == "--threshold") {
+            config.thresholdPercent = std::atof(value.c_str());
+        } else if (arg == "--threshold-for") {
+            size_t equals = value.find('=');
+            if (equals == std::string::npos) {
+                std::cerr << "--threshold-for expects name=percent" << std::endl;
+                return false;
+            }
+            config.thresholdFor[value.substr(0, equals)] = std::atof(value.c_str() + equals + 1);
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fixture data -------------------------------------------------------------
+
+struct Fixture {
+    std::vector<Ref<Course>> courses;
+    std::vector<Ref<Section>> unassigned;  // Durations only, as entered by the user
+    Schedule schedule;                                 // Same sections placed without any conflict
+    Schedule shuffled;                                 // Equivalent schedule, sections in reverse order
+    std::vector<TimeSlot> slots;
+};
+
+// n five-minute sections spread round-robin over the week so nothing overlaps
+// (the worst case for the conflict and equivalence checks, which stop early otherwise)
+Fixture makeFixture(int n) {
+    Fixture fixture;
+    int courseCount = std::max(1, n / 4);
+    for (int c = 0; c < courseCount; c++) {
+        fixture.courses.push_back(makeRef<Course>("C" + std::to_string(c), "Course", 3));
+    }
+    auto teacher = makeRef<Teacher>("T1", "Teacher");
+
+    std::vector<Ref<Section>> placed;
+    for (int i = 0; i < n; i++) {
+        auto course = fixture.courses[i % courseCount];
+        std::string id = course->getCode() + "-" + std::to_string(i);
+        int durations[] = { 60, 75, 90 };
+        fixture.unassigned.push_back(makeRef<Section>(id, course, teacher, TimeSlot(durations[i % 3])));
+
+        int minutes = (i / 5) * 5;
+        TimeSlot slot(5, static_cast<TimeSlot::Day>(i % 5), minutes / 60, minutes % 60);
+        placed.push_back(makeRef<Section>(id, course, teacher, slot));
+        fixture.slots.push_back(slot);
+    }
+
+    for (const auto& section : placed) {
+        fixture.schedule.addSection(section);
+    }
+    for (auto it = placed.rbegin(); it != placed.rend(); ++it) {
+        fixture.shuffled.addSection(*it);
+    }
+    return fixture;
+}
+
+void printResult(const microbench::Result& result, const std::map<std::string, double>& baseline) {
+    std::cout << std::left << std::setw(36) << result.name << std::right << std::setw(6) << result.size
+              << std::fixed << std::setprecision(1)
+              << std::setw(14) << result.medianNs << std::setw(14) << result.minNs
+              << std::setw(12) << result.stddevNs;
+    auto it = baseline.find(result.key());
+    if (it != baseline.end() && it->second > 0.0) {
+        std::cout << std::setw(10) << std::showpos << (result.medianNs / it->second - 1.0) * 100.0
+                  << "%" << std::noshowpos;
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    if (!parseArgs(argc, argv, config)) {
+        return 2;
+    }
+    Logger::setLevel(LogLevel::WARN);
+
+    std::map<std::string, double> baseline;
+    if (!config.baselinePath.empty() && !microbench::readBaseline(config.baselinePath, baseline)) {
+        std::cerr << "Could not read baseline " << config.baselinePath << std::endl;
+        return 2;
+    }
+
+    std::cout << std::left << std::setw(36) << "benchmark" << std::right << std::setw(6) << "size"
+              << std::setw(14) << "median ns" << std::setw(14) << "min ns" << std::setw(12) << "stddev"
+              << (baseline.empty() ? "" : "  vs base") << "\n";
+
+    std::vector<microbench::Result> results;
+    Scheduler scheduler;
+
+    for (int n : config.sizes) {
+        Fixture fixture = makeFixture(n);
+        PQTree tree;
+        tree.buildTimeOrderedTree(fixture.unassigned);
+
+        // Every body does the work for the whole fixture once, so times are per size-n operation
+        std::vector<std::pair<std::string, std::function<void()>>> benchmarks = {
+            { "TimeSlot::overlaps", [&]() {
+                int overlapping = 0;
+                for (size_t i = 0; i + 1 < fixture.slots.size(); i++) {
+                    overlapping += fixture.slots[i].overlaps(fixture.slots[i + 1]);
+                }
+                microbench::keep(overlapping);
+            } },
+            { "Schedule::hasConflicts", [&]() {
+                bool conflicts = fixture.schedule.hasConflicts();
+                microbench::keep(conflicts);
+            } },
+            { "Scheduler::areSchedulesEquivalent", [&]() {
+                bool equivalent = scheduler.areSchedulesEquivalent(fixture.schedule, fixture.shuffled);
+                microbench::keep(equivalent);
+            } },
+            { "Schedule::getSectionsForCourse", [&]() {
+                auto found = fixture.schedule.getSectionsForCourse(*fixture.courses.back());
+                microbench::keep(found);
+            } },
+            { "Schedule::getSectionsForTeacher", [&]() {
+                auto found = fixture.schedule.getSectionsForTeacher(*fixture.unassigned.front()->getTeacher());
+                microbench::keep(found);
+            } },
+            { "PQTree::buildTimeOrderedTree", [&]() {
+                PQTree built;
+                built.buildTimeOrderedTree(fixture.unassigned);
+                microbench::keep(built);
+            } },
+            { "PQTree::getFrontiers", [&]() {
+                auto frontiers = tree.getFrontiers();
+                microbench::keep(frontiers);
+            } },
+            { "PQTree::computeLayout", [&]() {
+                tree.computeLayout();
+            } },
+        };
+
+        for (const auto& benchmark : benchmarks) {
+            if (!config.filter.empty() && benchmark.first.find(config.filter) == std::string::npos) {
+                continue;
+            }
+            results.push_back(microbench::run(benchmark.first, n, benchmark.second, config.settings));
+            printResult(results.back(), baseline);
+        }
+    }
+
+    if (!config.outputPath.empty()) {
+        std::ofstream out(config.outputPath, std::ios::trunc);
+        if (!out) {
+            std::cerr << "Could not write " << config.outputPath << std::endl;
+            return 2;
+        }
+        microbench::writeJson(out, results);
+    }
+
+    // Compare against the baseline, benchmarks missing from it are new and always pass
+    int regressions = 0;
+    for (const auto& result : results) {
+        auto it = baseline.find(result.key());
+        if (it == baseline.end() || it->second <= 0.0) {
+            continue;
+        }
+        auto threshold = config.thresholdFor.find(result.name);
+        double allowed = threshold != config.thresholdFor.end() ? threshold->second : config.thresholdPercent;
+        double change = (result.medianNs / it->second - 1.0) * 100.0;
+        if (change > allowed) {
+            std::cerr << "REGRESSION " << result.key() << ": " << std::fixed << std::setprecision(1)
+                      << change << "% slower than baseline (allowed " << allowed << "%)" << std::endl;
+            regressions++;
+        }
+    }
+    return regressions > 0 ? 1 : 0;
+}
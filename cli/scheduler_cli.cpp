@@ -0,0 +1,383 @@
+// Headless front end: reads an instance file, runs one solver mode and writes
+// the schedules and solver statistics. No graphics dependencies.
+#include "Scheduler.hpp"
+#include "InstanceFile.hpp"
+#include "BulkImport.hpp"
+#include "Snapshot.hpp"
+#include "InstanceGenerator.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+const char* USAGE =
+    "Usage: scheduler_cli <instance-file> [options]\n"
+    "       (a .csv or .json file is read as a course/teacher/section extract,\n"
+    "        a .snap file restores a snapshot including its schedules)\n"
+    "       scheduler_cli --generate <courses> [--seed N] [--teachers N] [--output FILE]\n"
+    "\n"
+    "Solving:\n"
+    "  --mode enumerate|local|sat   Solver to run (default enumerate)\n"
+    "  --time-budget-ms N           Wall-clock budget for the solve\n"
+    "  --max-schedules N            Stop after N valid schedules\n"
+    "  --retain K                   Keep the best K schedules (default 100)\n"
+    "  --seed N                     Seed for local search (and --generate)\n"
+    "  --cache-dir DIR              Reuse results of identical solves across runs\n"
+    "  --edit RECORD                Apply an instance file record after loading (repeatable);\n"
+    "                               one added or pinned section on a solved snapshot is\n"
+    "                               repaired around instead of solving again\n"
+    "\n"
+    "Output:\n"
+    "  --output FILE                Write results here instead of stdout\n"
+    "  --format text|json           Result format (default text)\n"
+    "  --schedules N                How many schedules to print, best first (default 1, 0 = all)\n"
+    "  --stats                      Append solver statistics\n"
+    "  --log-level LEVEL            trace, debug, info, warn, error or off (default warn)\n"
+    "  --trace FILE                 Write a Chrome trace of the solve\n"
+    "  --snapshot FILE              Save inputs and schedules as a binary snapshot\n";
+
+struct CliOptions {
+    std::string instancePath;
+    SolveOptions solve;
+    size_t retain = 100;
+    std::string cacheDirectory;
+    std::string outputPath;
+    bool json = false;
+    int scheduleCount = 1;
+    bool stats = false;
+    std::string tracePath;
+    std::string snapshotPath;
+    std::vector<std::string> edits;
+    int generateCourses = 0;
+    int generateTeachers = 0;
+    uint32_t seed = 1;
+};
+
+bool parseArgs(int argc, char** argv, CliOptions& options, std::string& error) {
+    options.solve.localSearch.seed = options.seed;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.size() < 2 || arg.compare(0, 2, "--") != 0) {
+            if (!options.instancePath.empty()) {
+                error = "more than one instance file given";
+                return false;
+            }
+            options.instancePath = arg;
+            continue;
+        }
+        if (arg == "--stats") {
+            options.stats = true;
+            continue;
+        }
+        if (arg == "--help") {
+            error = "";
+            return false;
+        }
+        if (i + 1 >= argc) {
+            error = "missing value for " + arg;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--mode") {
+            if (value == "enumerate") options.solve.mode = SolverMode::ENUMERATE;
+            else if (value == "local") options.solve.mode = SolverMode::LOCAL_SEARCH;
+            else if (value == "sat") options.solve.mode = SolverMode::SAT;
+            else {
+                error = "unknown mode " + value;
+                return false;
+            }
+        } else if (arg == "--time-budget-ms") {
+            options.solve.timeBudgetMs = std::atoi(value.c_str());
+        } else if (arg == "--max-schedules") {
+            options.solve.maxSchedules = std::atol(value.c_str());
+        } else if (arg == "--retain") {
+            options.retain = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--seed") {
+            options.seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+            options.solve.localSearch.seed = options.seed;
+        } else if (arg == "--cache-dir") {
+            options.cacheDirectory = value;
+        } else if (arg == "--output") {
+            options.outputPath = value;
+        } else if (arg == "--format") {
+            if (value != "text" && value != "json") {
+                error = "unknown format " + value;
+                return false;
+            }
+            options.json = value == "json";
+        } else if (arg == "--schedules") {
+            options.scheduleCount = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--log-level") {
+            LogLevel level;
+            if (!Logger::parseLevel(value, level)) {
+                error = "unknown log level " + value;
+                return false;
+            }
+            Logger::setLevel(level);
+        } else if (arg == "--trace") {
+            options.tracePath = value;
+        } else if (arg == "--snapshot") {
+            options.snapshotPath = value;
+        } else if (arg == "--edit") {
+            options.edits.push_back(value);
+        } else if (arg == "--generate") {
+            options.generateCourses = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--teachers") {
+            options.generateTeachers = std::max(1, std::atoi(value.c_str()));
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+
+    if (options.instancePath.empty() && options.generateCourses == 0) {
+        error = "no instance file given";
+        return false;
+    }
+    return true;
+}
+
+// Bulk CSV/JSON extracts go through BulkImport, anything else is an instance file
+bool isExtract(const std::string& path) {
+    auto endsWith = [&](const char* suffix) {
+        size_t length = std::strlen(suffix);
+        return path.size() > length && path.compare(path.size() - length, length, suffix) == 0;
+    };
+    return endsWith(".csv") || endsWith(".json");
+}
+
+bool isSnapshot(const std::string& path) {
+    return path.size() > 5 && path.compare(path.size() - 5, 5, ".snap") == 0;
+}
+
+const char* statusName(SolveStatus status) {
+    switch (status) {
+        case SolveStatus::TIMED_OUT:     return "timed_out";
+        case SolveStatus::CANCELLED:     return "cancelled";
+        case SolveStatus::LIMIT_REACHED: return "limit_reached";
+        default:                         return "completed";
+    }
+}
+
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            quoted += escaped;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string formatStart(const TimeSlot& slot) {
+    if (!slot.hasStartTime()) {
+        return "--:--";
+    }
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "%02d:%02d", slot.getStartHour(), slot.getStartMinute());
+    return buffer;
+}
+
+void writeText(std::ostream& out, const Scheduler& scheduler, bool found,
+               const std::vector<std::shared_ptr<Schedule>>& schedules, bool withStats) {
+    out << "status: " << statusName(scheduler.getLastSolveStatus()) << "\n"
+        << "satisfies all requirements: " << (found ? "yes" : "no") << "\n"
+        << "schedules: " << scheduler.getAllPossibleSchedules().size() << "\n";
+
+    for (size_t i = 0; i < schedules.size(); i++) {
+        out << "\nSchedule " << i + 1 << " (score " << scheduler.scoreSchedule(*schedules[i])
+            << (schedules[i] == scheduler.getCurrentSchedule() ? ", selected" : "") << ")\n";
+        for (const auto& section : schedules[i]->getSections()) {
+            const TimeSlot& slot = section->getTimeSlot();
+            out << "  " << section->getId() << "  " << InstanceFile::dayToken(slot.getDay()) << " "
+                << formatStart(slot) << " " << slot.getDurationMinutes() << "min  "
+                << section->getCourse()->getCode() << "  " << section->getTeacher()->getName() << "\n";
+        }
+    }
+
+    if (withStats) {
+        out << "\n" << scheduler.getLastSolverStats().toString() << "\n";
+    }
+}
+
+void writeJson(std::ostream& out, const Scheduler& scheduler, bool found,
+               const std::vector<std::shared_ptr<Schedule>>& schedules, bool withStats) {
+    out << "{\n  \"status\": \"" << statusName(scheduler.getLastSolveStatus()) << "\",\n"
+        << "  \"found\": " << (found ? "true" : "false") << ",\n"
+        << "  \"schedule_count\": " << scheduler.getAllPossibleSchedules().size() << ",\n"
+        << "  \"schedules\": [";
+
+    for (size_t i = 0; i < schedules.size(); i++) {
+        out << (i ? ",\n" : "\n") << "    {\"score\": " << scheduler.scoreSchedule(*schedules[i])
+            << ", \"selected\": " << (schedules[i] == scheduler.getCurrentSchedule() ? "true" : "false")
+            << ", \"sections\": [";
+        const auto& sections = schedules[i]->getSections();
+        for (size_t j = 0; j < sections.size(); j++) {
+            const TimeSlot& slot = sections[j]->getTimeSlot();
+            out << (j ? ",\n" : "\n") << "      {\"id\": " << jsonString(sections[j]->getId())
+                << ", \"course\": " << jsonString(sections[j]->getCourse()->getCode())
+                << ", \"teacher\": " << jsonString(sections[j]->getTeacher()->getId())
+                << ", \"day\": \"" << InstanceFile::dayToken(slot.getDay()) << "\""
+                << ", \"start\": \"" << formatStart(slot) << "\""
+                << ", \"minutes\": " << slot.getDurationMinutes() << "}";
+        }
+        out << "\n    ]}";
+    }
+    out << "\n  ]";
+
+    if (withStats) {
+        const SolverStats& stats = scheduler.getLastSolverStats();
+        out << ",\n  \"stats\": {\"total_ms\": " << stats.totalNanos / 1e6
+            << ", \"from_cache\": " << (stats.fromCache ? "true" : "false") << ", \"phases_ms\": {";
+        for (int i = 0; i < SolverStats::PHASE_COUNT; i++) {
+            auto phase = static_cast<SolvePhase>(i);
+            out << (i ? ", " : "") << jsonString(SolverStats::phaseName(phase)) << ": " << stats.phaseMs(phase);
+        }
+        out << "}, \"rejections\": {";
+        for (int i = 0; i < SolverStats::REASON_COUNT; i++) {
+            auto reason = static_cast<RejectReason>(i);
+            out << (i ? ", " : "") << jsonString(SolverStats::reasonName(reason)) << ": " << stats.rejected(reason);
+        }
+        out << "}, \"permutations_enumerated\": " << stats.permutationsEnumerated
+            << ", \"packing_failures\": " << stats.packingFailures
+            << ", \"conflict_rejects\": " << stats.conflictRejects
+            << ", \"dedupe_hits\": " << stats.dedupeHits
+            << ", \"requirement_failures\": " << stats.requirementFailures << "}";
+    }
+    out << "\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Logger::setLevel(LogLevel::WARN);
+
+    CliOptions options;
+    std::string error;
+    if (!parseArgs(argc, argv, options, error)) {
+        if (!error.empty()) {
+            std::cerr << "scheduler_cli: " << error << "\n\n";
+        }
+        std::cerr << USAGE;
+        return error.empty() ? 0 : 2;
+    }
+
+    std::ofstream file;
+    if (!options.outputPath.empty()) {
+        file.open(options.outputPath, std::ios::trunc);
+        if (!file) {
+            std::cerr << "scheduler_cli: cannot write " << options.outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = options.outputPath.empty() ? std::cout : file;
+
+    Scheduler scheduler;
+
+    // Write a synthetic instance instead of solving
+    if (options.generateCourses > 0) {
+        InstanceOptions instance;
+        instance.courses = options.generateCourses;
+        instance.teachers = options.generateTeachers > 0 ? options.generateTeachers
+                                                         : std::max(2, options.generateCourses / 2);
+        instance.seed = options.seed;
+        InstanceGenerator(instance).populate(scheduler);
+        InstanceFile::write(out, scheduler);
+        return 0;
+    }
+
+    Snapshot snapshot;
+    if (isSnapshot(options.instancePath)) {
+        if (!snapshot.open(options.instancePath, error) || !snapshot.restore(scheduler, error)) {
+            std::cerr << "scheduler_cli: " << error << std::endl;
+            return 1;
+        }
+    } else if (isExtract(options.instancePath)) {
+        ImportReport report;
+        if (!BulkImport::importFile(options.instancePath, scheduler, report, error)) {
+            std::cerr << "scheduler_cli: " << error << std::endl;
+            return 1;
+        }
+        if (report.rejected > 0) {
+            std::cerr << "scheduler_cli: " << report.toString() << std::endl;
+        }
+    } else if (!InstanceFile::load(options.instancePath, scheduler, error)) {
+        std::cerr << "scheduler_cli: " << error << std::endl;
+        return 1;
+    }
+
+    scheduler.setMaxRetainedSchedules(options.retain);
+    if (!options.cacheDirectory.empty()) {
+        scheduler.setSolveCacheDirectory(options.cacheDirectory);
+    }
+    if (!options.tracePath.empty()) {
+        Tracer::setThreadName("main");
+        Tracer::setEnabled(true);
+    }
+
+    for (const auto& edit : options.edits) {
+        if (!InstanceFile::readLine(edit, scheduler, error)) {
+            std::cerr << "scheduler_cli: --edit '" << edit << "': " << error << std::endl;
+            return 1;
+        }
+    }
+
+    bool found;
+    if (!options.edits.empty()) {
+        found = scheduler.resolveAfterEdits(options.solve);
+    } else if (snapshot.scheduleCount() > 0) {
+        // Already solved: report the saved schedules instead of solving again
+        auto current = scheduler.getCurrentSchedule();
+        const auto& requirements = scheduler.getRequirements();
+        found = current && std::all_of(requirements.begin(), requirements.end(),
+                                       [&](const std::shared_ptr<Requirement>& requirement) {
+                                           return requirement->isSatisfied(*current);
+                                       });
+    } else {
+        found = scheduler.generateSchedule(options.solve);
+    }
+
+    auto all = scheduler.getAllPossibleSchedules();
+    size_t count = options.scheduleCount == 0 ? all.size()
+                                              : std::min(all.size(), static_cast<size_t>(options.scheduleCount));
+    std::vector<std::shared_ptr<Schedule>> printed(all.begin(), all.begin() + count);
+
+    if (options.json) {
+        writeJson(out, scheduler, found, printed, options.stats);
+    } else {
+        writeText(out, scheduler, found, printed, options.stats);
+    }
+
+    if (!options.snapshotPath.empty() && !Snapshot::save(options.snapshotPath, scheduler, error)) {
+        std::cerr << "scheduler_cli: " << error << std::endl;
+        return 1;
+    }
+    if (!options.tracePath.empty() && !Tracer::writeJsonFile(options.tracePath)) {
+        std::cerr << "scheduler_cli: cannot write trace " << options.tracePath << std::endl;
+    }
+    Logger::flush();
+
+    // Distinguish "nothing valid" from "valid but some requirement unmet" for scripts
+    if (all.empty()) {
+        return 3;
+    }
+    return found ? 0 : 4;
+}
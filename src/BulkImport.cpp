@@ -0,0 +1,699 @@
+#include "BulkImport.hpp"
+#include "MappedFile.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <deque>
+#include <sstream>
+
+namespace {
+
+enum class Field { NONE, TYPE, ID, CODE, NAME, CREDITS, COURSE, TEACHER, MINUTES };
+
+// One course, teacher or section record. Views point into the input buffer, or
+// into the reader's scratch space for fields that needed unescaping.
+struct Row {
+    size_t line = 0;
+    std::string_view type, id, code, name, credits, course, teacher, minutes;
+
+    std::string_view* field(Field which) {
+        switch (which) {
+            case Field::TYPE:    return &type;
+            case Field::ID:      return &id;
+            case Field::CODE:    return &code;
+            case Field::NAME:    return &name;
+            case Field::CREDITS: return &credits;
+            case Field::COURSE:  return &course;
+            case Field::TEACHER: return &teacher;
+            case Field::MINUTES: return &minutes;
+            default:             return nullptr;
+        }
+    }
+};
+
+bool equalsIgnoreCase(std::string_view text, std::string_view lower) {
+    if (text.size() != lower.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(text[i])) != lower[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+Field fieldFor(std::string_view name) {
+    name = trim(name);
+    static const std::pair<const char*, Field> names[] = {
+        { "type", Field::TYPE }, { "id", Field::ID }, { "code", Field::CODE }, { "name", Field::NAME },
+        { "credits", Field::CREDITS }, { "course", Field::COURSE }, { "teacher", Field::TEACHER },
+        { "minutes", Field::MINUTES }, { "duration", Field::MINUTES },
+    };
+    for (const auto& entry : names) {
+        if (equalsIgnoreCase(name, entry.first)) {
+            return entry.second;
+        }
+    }
+    return Field::NONE;
+}
+
+bool parseInt(std::string_view text, int& value) {
+    text = trim(text);
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+std::string quoted(std::string_view text) {
+    return "'" + std::string(text) + "'";
+}
+
+// Adds rows to the scheduler, deduplicating by id through the scheduler's
+// registries. Deferred sections keep views into the input buffer wherever possible.
+class Loader {
+public:
+    Loader(Scheduler& scheduler, ImportReport& report, std::string_view buffer)
+        : scheduler(scheduler), report(report), buffer(buffer) {}
+
+    // `kind` applies when the row has no type of its own
+    void add(const Row& row, std::string_view kind) {
+        report.rows++;
+        if (!row.type.empty()) {
+            kind = trim(row.type);
+        }
+
+        if (equalsIgnoreCase(kind, "course")) {
+            addCourse(row);
+        } else if (equalsIgnoreCase(kind, "teacher")) {
+            addTeacher(row);
+        } else if (equalsIgnoreCase(kind, "section")) {
+            std::string_view id = trim(row.id), course = trim(row.course), teacher = trim(row.teacher);
+            int minutes = 0;
+            if (id.empty() || course.empty() || teacher.empty()) {
+                reject(row.line, "section needs id, course and teacher");
+            } else if (!parseInt(row.minutes, minutes) || minutes <= 0) {
+                reject(row.line, "section " + std::string(id) + " needs a positive minutes value");
+            } else if (!addSection(id, course, teacher, minutes)) {
+                // Course or teacher may still be further down the file
+                pending.push_back({ keep(id), keep(course), keep(teacher), minutes, row.line });
+            }
+        } else {
+            reject(row.line, kind.empty() ? "row has no type" : "unknown type " + quoted(kind));
+        }
+    }
+
+    // Places the sections whose course or teacher came later in the input
+    void finish() {
+        for (const auto& section : pending) {
+            if (addSection(section.id, section.course, section.teacher, section.minutes)) {
+                continue;
+            }
+            reject(section.line, scheduler.findCourse(section.course) ? "unknown teacher " + quoted(section.teacher)
+                                                                      : "unknown course " + quoted(section.course));
+        }
+        pending.clear();
+    }
+
+private:
+    struct Pending {
+        std::string_view id, course, teacher;
+        int minutes;
+        size_t line;
+    };
+
+    void addCourse(const Row& row) {
+        std::string_view code = trim(row.code.empty() ? row.id : row.code);
+        int credits = 0;
+        if (code.empty()) {
+            reject(row.line, "course needs a code");
+        } else if (!row.credits.empty() && !parseInt(row.credits, credits)) {
+            reject(row.line, "course " + std::string(code) + " has invalid credits " + quoted(row.credits));
+        } else if (scheduler.findCourse(code)) {
+            report.duplicates++;
+        } else {
+            scheduler.addCourse(makeRef<Course>(std::string(code), std::string(trim(row.name)), credits));
+            report.courses++;
+        }
+    }
+
+    void addTeacher(const Row& row) {
+        std::string_view id = trim(row.id);
+        if (id.empty()) {
+            reject(row.line, "teacher needs an id");
+        } else if (scheduler.findTeacher(id)) {
+            report.duplicates++;
+        } else {
+            scheduler.addTeacher(makeRef<Teacher>(std::string(id), std::string(trim(row.name))));
+            report.teachers++;
+        }
+    }
+
+    // False when the course or teacher is not known (yet)
+    bool addSection(std::string_view id, std::string_view courseCode, std::string_view teacherId, int minutes) {
+        if (scheduler.findSection(id)) {
+            report.duplicates++;
+            return true;
+        }
+        auto course = scheduler.findCourse(courseCode);
+        auto teacher = scheduler.findTeacher(teacherId);
+        if (!course || !teacher) {
+            return false;
+        }
+        scheduler.addSection(makeRef<Section>(std::string(id), course, teacher,
+                                                       TimeSlot(minutes)));
+        report.sections++;
+        return true;
+    }
+
+    void reject(size_t line, const std::string& reason) {
+        report.rejected++;
+        if (report.errors.size() < ImportReport::MAX_ERRORS) {
+            report.errors.push_back("line " + std::to_string(line) + ": " + reason);
+        }
+    }
+
+    // A view that outlives the current row
+    std::string_view keep(std::string_view text) {
+        if (text.data() >= buffer.data() && text.data() + text.size() <= buffer.data() + buffer.size()) {
+            return text;
+        }
+        return own(std::string(text));
+    }
+
+    std::string_view own(std::string text) {
+        owned.push_back(std::move(text));
+        return owned.back();
+    }
+
+    Scheduler& scheduler;
+    ImportReport& report;
+    std::string_view buffer;
+    std::deque<std::string> owned;  // Stable storage for deferred keys not in the buffer
+    std::vector<Pending> pending;
+};
+
+// RFC 4180 records: comma separated, double quotes around fields that contain
+// commas, quotes ("" inside) or line breaks. Unquoted fields are trimmed.
+class CsvReader {
+public:
+    explicit CsvReader(std::string_view data) : data(data) {
+        if (data.substr(0, 3) == "\xEF\xBB\xBF") {
+            pos = 3;  // UTF-8 byte order mark
+        }
+    }
+
+    // Fields of the next non-blank record; false at the end of input or on error
+    bool next(std::vector<std::string_view>& fields, size_t& recordLine) {
+        fields.clear();
+        unescaped.clear();
+        while (pos < data.size() && (data[pos] == '\n' || data[pos] == '\r')) {
+            line += data[pos] == '\n';
+            pos++;
+        }
+        if (pos >= data.size()) {
+            return false;
+        }
+        recordLine = line;
+
+        while (true) {
+            std::string_view field;
+            if (data[pos] == '"') {
+                if (!readQuoted(field)) {
+                    return false;
+                }
+            } else {
+                size_t end = pos;
+                while (end < data.size() && data[end] != ',' && data[end] != '\n') end++;
+                field = trim(data.substr(pos, end - pos));
+                pos = end;
+            }
+            fields.push_back(field);
+
+            if (pos >= data.size()) {
+                return true;
+            }
+            if (data[pos] == '\n') {
+                pos++;
+                line++;
+                return true;
+            }
+            pos++;  // Comma
+        }
+    }
+
+    const std::string& error() const { return problem; }
+
+private:
+    bool readQuoted(std::string_view& field) {
+        size_t start = ++pos;
+        bool escaped = false;
+        while (true) {
+            if (pos >= data.size()) {
+                problem = "line " + std::to_string(line) + ": unterminated quoted field";
+                return false;
+            }
+            char c = data[pos];
+            if (c == '"' && pos + 1 < data.size() && data[pos + 1] == '"') {
+                escaped = true;
+                pos += 2;
+            } else if (c == '"') {
+                break;
+            } else {
+                line += c == '\n';
+                pos++;
+            }
+        }
+        field = data.substr(start, pos - start);
+        pos++;  // Closing quote
+
+        if (escaped) {
+            std::string text;
+            text.reserve(field.size());
+            for (size_t i = 0; i < field.size(); i++) {
+                text += field[i];
+                i += field[i] == '"';  // Skip the second quote of a pair
+            }
+            unescaped.push_back(std::move(text));
+            field = unescaped.back();
+        }
+
+        while (pos < data.size() && (data[pos] == ' ' || data[pos] == '\t' || data[pos] == '\r')) pos++;
+        if (pos < data.size() && data[pos] != ',' && data[pos] != '\n') {
+            problem = "line " + std::to_string(line) + ": unexpected character after quoted field";
+            return false;
+        }
+        return true;
+    }
+
+    std::string_view data;
+    size_t pos = 0;
+    size_t line = 1;
+    std::deque<std::string> unescaped;  // Fields of the current record that had "" pairs
+    std::string problem;
+};
+
+bool importCsv(std::string_view data, Loader& loader, std::string& error) {
+    CsvReader reader(data);
+    std::vector<std::string_view> fields;
+    size_t line = 0;
+
+    if (!reader.next(fields, line)) {
+        error = reader.error().empty() ? "missing header row" : reader.error();
+        return false;
+    }
+    std::vector<Field> columns;
+    bool present[static_cast<int>(Field::MINUTES) + 1] = {};
+    for (auto name : fields) {
+        columns.push_back(fieldFor(name));
+        present[static_cast<int>(columns.back())] = true;
+    }
+
+    // Without a type column every row is the kind the columns describe
+    std::string_view kind;
+    if (present[static_cast<int>(Field::TYPE)]) {
+        kind = "";
+    } else if (present[static_cast<int>(Field::COURSE)] && present[static_cast<int>(Field::TEACHER)]) {
+        kind = "section";
+    } else if (present[static_cast<int>(Field::CODE)] || present[static_cast<int>(Field::CREDITS)]) {
+        kind = "course";
+    } else if (present[static_cast<int>(Field::ID)]) {
+        kind = "teacher";
+    } else {
+        error = "line " + std::to_string(line) + ": header names none of type, id, code, course, teacher";
+        return false;
+    }
+
+    Row row;
+    while (reader.next(fields, line)) {
+        row = Row();
+        row.line = line;
+        for (size_t i = 0; i < fields.size() && i < columns.size(); i++) {
+            if (auto* value = row.field(columns[i])) {
+                *value = fields[i];
+            }
+        }
+        loader.add(row, kind);
+    }
+    if (!reader.error().empty()) {
+        error = reader.error();
+        return false;
+    }
+    return true;
+}
+
+// Pull parser for the subset of JSON the import needs: objects, arrays and
+// scalars, with strings handed out as views unless they contain escapes
+class JsonReader {
+public:
+    explicit JsonReader(std::string_view data) : data(data) {}
+
+    size_t line() const { return lineNumber; }
+    bool failed() const { return !problem.empty(); }
+    const std::string& error() const { return problem; }
+
+    // Drops unescaped strings handed out so far
+    void releaseScratch() { scratch.clear(); }
+
+    char peek() {
+        skipSpace();
+        return pos < data.size() ? data[pos] : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() != c) {
+            return false;
+        }
+        pos++;
+        return true;
+    }
+
+    bool expect(char c) {
+        if (consume(c)) {
+            return true;
+        }
+        return fail(std::string("expected '") + c + "'");
+    }
+
+    bool atEnd() {
+        return peek() == '\0' && pos >= data.size();
+    }
+
+    bool readString(std::string_view& out) {
+        if (!expect('"')) {
+            return false;
+        }
+        size_t start = pos;
+        while (pos < data.size() && data[pos] != '"' && data[pos] != '\\') {
+            if (static_cast<unsigned char>(data[pos]) < 0x20) {
+                return fail("control character in string");
+            }
+            pos++;
+        }
+        if (pos < data.size() && data[pos] == '"') {
+            out = data.substr(start, pos++ - start);
+            return true;
+        }
+
+        // Escapes present: decode into scratch space
+        std::string text(data.substr(start, pos - start));
+        while (pos < data.size() && data[pos] != '"') {
+            char c = data[pos++];
+            if (c != '\\') {
+                text += c;
+                continue;
+            }
+            if (pos >= data.size()) break;
+            char escape = data[pos++];
+            switch (escape) {
+                case '"': case '\\': case '/': text += escape; break;
+                case 'b': text += '\b'; break;
+                case 'f': text += '\f'; break;
+                case 'n': text += '\n'; break;
+                case 'r': text += '\r'; break;
+                case 't': text += '\t'; break;
+                case 'u': {
+                    unsigned code = 0;
+                    if (!readHex(code)) return false;
+                    if (code >= 0xD800 && code <= 0xDBFF && data.substr(pos, 2) == "\\u") {
+                        pos += 2;
+                        unsigned low = 0;
+                        if (!readHex(low)) return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(text, code);
+                    break;
+                }
+                default:
+                    return fail("invalid escape in string");
+            }
+        }
+        if (pos >= data.size()) {
+            return fail("unterminated string");
+        }
+        pos++;
+        scratch.push_back(std::move(text));
+        out = scratch.back();
+        return true;
+    }
+
+    // A string, or the text of a number/true/false; null reads as empty
+    bool readScalar(std::string_view& out) {
+        char c = peek();
+        if (c == '"') {
+            return readString(out);
+        }
+        if (c == '{' || c == '[') {
+            return fail("expected a string or number");
+        }
+        size_t start = pos;
+        while (pos < data.size() && (std::isalnum(static_cast<unsigned char>(data[pos])) ||
+                                     data[pos] == '-' || data[pos] == '+' || data[pos] == '.')) {
+            pos++;
+        }
+        if (pos == start) {
+            return fail("expected a value");
+        }
+        out = data.substr(start, pos - start);
+        if (out == "null") {
+            out = std::string_view();
+        }
+        return true;
+    }
+
+    bool skipValue() {
+        char c = peek();
+        if (c == '{' || c == '[') {
+            char close = c == '{' ? '}' : ']';
+            pos++;
+            if (consume(close)) {
+                return true;
+            }
+            do {
+                std::string_view ignored;
+                if (c == '{' && (!readString(ignored) || !expect(':'))) {
+                    return false;
+                }
+                if (!skipValue()) {
+                    return false;
+                }
+            } while (consume(','));
+            return expect(close);
+        }
+        std::string_view ignored;
+        return readScalar(ignored);
+    }
+
+    bool fail(const std::string& reason) {
+        if (problem.empty()) {
+            problem = "line " + std::to_string(lineNumber) + ": " + reason;
+        }
+        return false;
+    }
+
+private:
+    // Raw newlines only occur between tokens, so counting them here is enough
+    void skipSpace() {
+        while (pos < data.size()) {
+            char c = data[pos];
+            if (c == '\n') {
+                lineNumber++;
+            } else if (c != ' ' && c != '\t' && c != '\r') {
+                break;
+            }
+            pos++;
+        }
+    }
+
+    bool readHex(unsigned& code) {
+        if (pos + 4 > data.size()) {
+            return fail("truncated \\u escape");
+        }
+        auto result = std::from_chars(data.data() + pos, data.data() + pos + 4, code, 16);
+        if (result.ptr != data.data() + pos + 4) {
+            return fail("invalid \\u escape");
+        }
+        pos += 4;
+        return true;
+    }
+
+    static void appendUtf8(std::string& text, unsigned code) {
+        if (code < 0x80) {
+            text += static_cast<char>(code);
+        } else if (code < 0x800) {
+            text += static_cast<char>(0xC0 | (code >> 6));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            text += static_cast<char>(0xE0 | (code >> 12));
+            text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            text += static_cast<char>(0xF0 | (code >> 18));
+            text += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            text += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    std::string_view data;
+    size_t pos = 0;
+    size_t lineNumber = 1;
+    std::deque<std::string> scratch;
+    std::string problem;
+};
+
+bool readJsonRow(JsonReader& json, Row& row) {
+    row = Row();
+    json.peek();  // Step over the blanks first so the line is the object's own
+    row.line = json.line();
+    if (!json.expect('{')) {
+        return false;
+    }
+    if (json.consume('}')) {
+        return true;
+    }
+    do {
+        std::string_view key;
+        if (!json.readString(key) || !json.expect(':')) {
+            return false;
+        }
+        std::string_view* value = row.field(fieldFor(key));
+        if (value ? !json.readScalar(*value) : !json.skipValue()) {
+            return false;
+        }
+    } while (json.consume(','));
+    return json.expect('}');
+}
+
+bool readJsonRows(JsonReader& json, Loader& loader, std::string_view kind) {
+    if (!json.expect('[')) {
+        return false;
+    }
+    if (json.consume(']')) {
+        return true;
+    }
+    Row row;
+    do {
+        json.releaseScratch();
+        if (!readJsonRow(json, row)) {
+            return false;
+        }
+        loader.add(row, kind);
+    } while (json.consume(','));
+    return json.expect(']');
+}
+
+bool importJson(std::string_view data, Loader& loader, std::string& error) {
+    JsonReader json(data);
+    bool ok;
+    if (json.peek() == '[') {
+        ok = readJsonRows(json, loader, "");
+    } else if (json.expect('{')) {
+        ok = true;
+        if (!json.consume('}')) {
+            do {
+                std::string_view key;
+                if (!json.readString(key) || !json.expect(':')) {
+                    ok = false;
+                    break;
+                }
+                // Named by the collection, so its rows need no "type"
+                std::string_view kind = equalsIgnoreCase(key, "courses") ? "course"
+                                      : equalsIgnoreCase(key, "teachers") ? "teacher"
+                                      : equalsIgnoreCase(key, "sections") ? "section" : "";
+                if (kind.empty() ? !json.skipValue() : !readJsonRows(json, loader, kind)) {
+                    ok = false;
+                    break;
+                }
+            } while (json.consume(','));
+            ok = ok && json.expect('}');
+        }
+    } else {
+        ok = false;
+    }
+
+    if (ok && !json.atEnd()) {
+        json.fail("unexpected data after the document");
+        ok = false;
+    }
+    if (!ok) {
+        error = json.error();
+    }
+    return ok;
+}
+
+} // namespace
+
+std::string ImportReport::toString() const {
+    std::ostringstream out;
+    out << "Imported " << courses << " courses, " << teachers << " teachers and " << sections
+        << " sections from " << rows << " rows (" << duplicates << " duplicates, " << rejected << " rejected)";
+    for (const auto& error : errors) {
+        out << "\n  " << error;
+    }
+    if (rejected > errors.size()) {
+        out << "\n  ... and " << rejected - errors.size() << " more";
+    }
+    return out.str();
+}
+
+bool BulkImport::importFile(const std::string& path, Scheduler& scheduler, ImportReport& report,
+                            std::string& error, Format format) {
+    MappedFile file;
+    if (!file.open(path, error)) {
+        return false;
+    }
+    if (format == Format::AUTO) {
+        format = detectFormat(path, file.view());
+    }
+    if (!importBuffer(file.view(), format, scheduler, report, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool BulkImport::importBuffer(std::string_view data, Format format, Scheduler& scheduler,
+                              ImportReport& report, std::string& error) {
+    TRACE_SCOPE("BulkImport::importBuffer", "io");
+    auto start = std::chrono::steady_clock::now();
+    if (format == Format::AUTO) {
+        format = detectFormat("", data);
+    }
+
+    // One row per line (CSV) or object (JSON) is a close enough upper bound to size the tables once
+    size_t estimate = format == Format::CSV ? std::count(data.begin(), data.end(), '\n') + 1
+                                            : std::count(data.begin(), data.end(), '{');
+    Loader loader(scheduler, report, data);
+    scheduler.reserve(estimate, estimate, estimate);
+
+    bool ok = format == Format::CSV ? importCsv(data, loader, error) : importJson(data, loader, error);
+    loader.finish();
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    SLOG_INFO("import", "Read " << data.size() << " bytes in " << elapsedMs << " ms: " << report.toString());
+    return ok;
+}
+
+BulkImport::Format BulkImport::detectFormat(const std::string& path, std::string_view data) {
+    auto dot = path.rfind('.');
+    if (dot != std::string::npos) {
+        std::string_view extension = std::string_view(path).substr(dot + 1);
+        if (equalsIgnoreCase(extension, "csv")) return Format::CSV;
+        if (equalsIgnoreCase(extension, "json")) return Format::JSON;
+    }
+    auto first = data.find_first_not_of(" \t\r\n");
+    if (first != std::string_view::npos && (data[first] == '{' || data[first] == '[')) {
+        return Format::JSON;
+    }
+    return Format::CSV;
+}
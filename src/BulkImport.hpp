@@ -0,0 +1,53 @@
+#ifndef BULK_IMPORT_HPP
+#define BULK_IMPORT_HPP
+
+#include "Scheduler.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// What one import added and what it skipped
+struct ImportReport {
+    size_t rows = 0;
+    size_t courses = 0;
+    size_t teachers = 0;
+    size_t sections = 0;
+    size_t duplicates = 0;            // Ids already loaded, first one wins
+    size_t rejected = 0;              // Malformed rows or unknown references
+    std::vector<std::string> errors;  // "line N: ..." for the first MAX_ERRORS rejected rows
+
+    static const size_t MAX_ERRORS = 20;
+
+    std::string toString() const;
+};
+
+// Streaming loader for course, teacher and section extracts in CSV or JSON.
+// Fields are parsed in place from a memory-mapped buffer; only the strings that
+// end up in the model are copied. Ids already in the scheduler (or seen earlier
+// in the file) are skipped, sections may come before their course or teacher.
+//
+// CSV needs a header row; column names are case-insensitive:
+//   courses:  code (or id), name, credits
+//   teachers: id, name
+//   sections: id, course, teacher, minutes (or duration)
+// A "type" column (course|teacher|section) allows mixing all three in one file,
+// otherwise the kind is taken from the columns present.
+//
+// JSON is either {"courses": [...], "teachers": [...], "sections": [...]} or an
+// array of objects with a "type" member, using the same names as the CSV columns.
+class BulkImport {
+public:
+    enum class Format { AUTO, CSV, JSON };
+
+    // False when the file cannot be read or is not well-formed; rows that are
+    // merely invalid are skipped and listed in the report instead
+    static bool importFile(const std::string& path, Scheduler& scheduler, ImportReport& report,
+                           std::string& error, Format format = Format::AUTO);
+    static bool importBuffer(std::string_view data, Format format, Scheduler& scheduler,
+                             ImportReport& report, std::string& error);
+
+    // From the extension (.csv, .json), falling back to the first non-blank byte
+    static Format detectFormat(const std::string& path, std::string_view data);
+};
+
+#endif // BULK_IMPORT_HPP
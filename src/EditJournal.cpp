@@ -0,0 +1,404 @@
+#include "EditJournal.hpp"
+#include "InstanceFile.hpp"
+#include "MappedFile.hpp"
+#include "Snapshot.hpp"
+#include "SolveCache.hpp"
+#include "Log.hpp"
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string checksum(uint32_t sequence, const std::string& record) {
+    return Fingerprint().add(static_cast<long long>(sequence)).add(record).toHex();
+}
+
+// Journal line for a change, empty when it cannot be expressed. Ids and names are
+// escaped, so ones holding blanks or '#' come back intact.
+std::string recordFor(const ModelChange& change) {
+    auto field = InstanceFile::escapeField;
+    switch (change.kind) {
+        case ModelChange::ADD_COURSE:         return InstanceFile::courseRecord(*change.course, true);
+        case ModelChange::REMOVE_COURSE:      return "remove-course " + field(change.course->getCode());
+        case ModelChange::ADD_TEACHER:        return InstanceFile::teacherRecord(*change.teacher, true);
+        case ModelChange::REMOVE_TEACHER:     return "remove-teacher " + field(change.teacher->getId());
+        case ModelChange::ASSIGN_COURSE:
+            return "assign " + field(change.teacher->getId()) + " " + field(change.course->getCode());
+        case ModelChange::ADD_SECTION:        return InstanceFile::sectionRecord(*change.section, true);
+        case ModelChange::REMOVE_SECTION:     return "remove-section " + field(change.section->getId());
+        case ModelChange::ADD_REQUIREMENT:    return InstanceFile::requirementRecord(*change.requirement, true);
+        case ModelChange::REMOVE_REQUIREMENT: return "remove-requirement " + std::to_string(change.index);
+        case ModelChange::ADD_PREFERENCE:     return InstanceFile::preferenceRecord(*change.preference, true);
+        case ModelChange::REMOVE_PREFERENCE:  return "remove-preference " + std::to_string(change.index);
+        case ModelChange::CLEAR:              return "clear";
+    }
+    return "";
+}
+
+// Next id or code of a record, unescaped
+bool readField(std::istringstream& fields, std::string& text) {
+    return fields >> text && InstanceFile::unescapeField(text, text);
+}
+
+// Applies one journal record; additions use the escaped instance file syntax
+bool applyRecord(const std::string& record, Scheduler& scheduler, std::string& error) {
+    std::istringstream fields(record);
+    std::string kind;
+    fields >> kind;
+
+    if (kind == "clear") {
+        scheduler.clear();
+    } else if (kind == "assign") {
+        std::string teacherId, courseCode;
+        readField(fields, teacherId) && readField(fields, courseCode);
+        auto teacher = scheduler.findTeacher(teacherId);
+        auto course = scheduler.findCourse(courseCode);
+        if (!teacher || !course) {
+            error = "unknown teacher or course in '" + record + "'";
+            return false;
+        }
+        scheduler.assignCourse(teacher, course);
+    } else if (kind == "remove-course") {
+        std::string code;
+        readField(fields, code);
+        auto course = scheduler.findCourse(code);
+        if (!course) {
+            error = "unknown course " + code;
+            return false;
+        }
+        scheduler.removeCourse(course);
+    } else if (kind == "remove-teacher") {
+        std::string id;
+        readField(fields, id);
+        auto teacher = scheduler.findTeacher(id);
+        if (!teacher) {
+            error = "unknown teacher " + id;
+            return false;
+        }
+        scheduler.removeTeacher(teacher);
+    } else if (kind == "remove-section") {
+        std::string id;
+        readField(fields, id);
+        auto section = scheduler.findSection(id);
+        if (!section) {
+            error = "unknown section " + id;
+            return false;
+        }
+        scheduler.removeSection(section);
+    } else if (kind == "remove-requirement" || kind == "remove-preference") {
+        size_t index = 0;
+        bool requirement = kind == "remove-requirement";
+        size_t count = requirement ? scheduler.getRequirements().size() : scheduler.getPreferences().size();
+        if (!(fields >> index) || index >= count) {
+            error = "no " + std::string(requirement ? "requirement" : "preference") + " at that index";
+            return false;
+        }
+        if (requirement) {
+            scheduler.removeRequirement(scheduler.getRequirements()[index]);
+        } else {
+            scheduler.removePreference(index);
+        }
+    } else {
+        return InstanceFile::readLine(record, scheduler, error, true);
+    }
+    return true;
+}
+
+bool syncFile(std::FILE* file) {
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Flushes a file written by someone else, and its directory so a rename sticks
+bool syncPath(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    bool ok = true;
+    std::string parent = std::filesystem::path(path).parent_path().string();
+    for (const std::string& target : { path, parent.empty() ? std::string(".") : parent }) {
+        int fd = ::open(target.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        ok = fsync(fd) == 0 && ok;
+        ::close(fd);
+    }
+    return ok;
+#endif
+}
+
+} // namespace
+
+EditJournal::EditJournal(const JournalOptions& options) : options(options) {}
+
+EditJournal::~EditJournal() {
+    close();
+}
+
+bool EditJournal::open(const std::string& snapshotPath, const std::string& journalPath, Scheduler& scheduler,
+                       std::string& error) {
+    close();
+    this->snapshotPath = snapshotPath;
+    this->journalPath = journalPath;
+
+    std::error_code ignored;
+    uint32_t snapshotSequence = 0;
+    if (std::filesystem::exists(snapshotPath, ignored)) {
+        Snapshot snapshot;
+        if (!snapshot.open(snapshotPath, error) || !snapshot.restore(scheduler, error)) {
+            return false;
+        }
+        snapshotSequence = snapshot.journalSequence();
+    } else {
+        scheduler.clear();
+    }
+
+    lastSequence = snapshotSequence;
+    replayedRecords = 0;
+    recordsSinceCompaction = 0;
+    if (std::filesystem::exists(journalPath, ignored) && !replay(snapshotSequence, scheduler, error)) {
+        return false;
+    }
+    durableSequence = lastSequence;
+
+    file = std::fopen(journalPath.c_str(), "ab");
+    if (!file) {
+        error = "cannot append to " + journalPath;
+        return false;
+    }
+    failed = false;
+    stopping = false;
+    writer = std::thread([this]() { run(); });
+
+    this->scheduler = &scheduler;
+    scheduler.setChangeListener([this](const ModelChange& change) { append(change); });
+    SLOG_INFO("journal", "Opened " << journalPath << " at record " << lastSequence << " ("
+              << replayedRecords << " replayed)");
+    return true;
+}
+
+bool EditJournal::replay(uint32_t after, Scheduler& scheduler, std::string& error) {
+    size_t goodBytes = 0;
+    bool torn = false;
+    {
+        MappedFile mapped;
+        if (!mapped.open(journalPath, error)) {
+            return false;
+        }
+        std::string_view data = mapped.view();
+        uint32_t previous = 0;
+
+        while (goodBytes < data.size()) {
+            size_t end = data.find('\n', goodBytes);
+            if (end == std::string_view::npos) {
+                torn = true;  // The last write never finished
+                break;
+            }
+            std::string_view line = data.substr(goodBytes, end - goodBytes);
+
+            // <sequence> <checksum> <record>
+            uint32_t sequence = 0;
+            auto parsed = std::from_chars(line.data(), line.data() + line.size(), sequence);
+            size_t hashStart = static_cast<size_t>(parsed.ptr - line.data()) + 1;
+            if (parsed.ec != std::errc() || hashStart + 17 > line.size() || line[hashStart - 1] != ' ' ||
+                line[hashStart + 16] != ' ' || sequence <= previous) {
+                torn = true;
+                break;
+            }
+            std::string record(line.substr(hashStart + 17));
+            if (line.substr(hashStart, 16) != checksum(sequence, record)) {
+                torn = true;
+                break;
+            }
+            previous = sequence;
+            goodBytes = end + 1;
+
+            if (sequence <= after) {
+                continue;  // Already folded into the snapshot
+            }
+            // The scheduler would no longer match what was recorded after it
+            std::string problem;
+            if (!applyRecord(record, scheduler, problem)) {
+                error = journalPath + ": record " + std::to_string(sequence) + ": " + problem;
+                return false;
+            }
+            lastSequence = sequence;
+            replayedRecords++;
+            recordsSinceCompaction++;
+        }
+    }
+
+    if (torn) {
+        // Cut the damaged tail so new records follow the last good one
+        SLOG_WARN("journal", "Discarding a damaged tail of " << journalPath << " after record " << lastSequence);
+        std::error_code resizeError;
+        std::filesystem::resize_file(journalPath, goodBytes, resizeError);
+        if (resizeError) {
+            error = "cannot truncate " + journalPath + ": " + resizeError.message();
+            return false;
+        }
+    }
+    return true;
+}
+
+void EditJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();  // Drains what is still pending
+    }
+
+    if (scheduler) {
+        scheduler->setChangeListener(nullptr);
+        scheduler = nullptr;
+    }
+    if (file) {
+        std::fclose(file);
+        file = nullptr;
+    }
+    pending.clear();
+    stopping = false;
+}
+
+bool EditJournal::isOpen() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return file != nullptr;
+}
+
+void EditJournal::append(const ModelChange& change) {
+    std::string record = recordFor(change);
+    if (record.empty()) {
+        SLOG_WARN("journal", "Change cannot be journaled and will be lost on restart");
+        return;
+    }
+    for (auto& c : record) {
+        if (c == '\n' || c == '\r') c = ' ';  // One record per line
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!file || failed) {
+        return;
+    }
+    uint32_t sequence = ++lastSequence;
+    pending += std::to_string(sequence) + " " + checksum(sequence, record) + " " + record + "\n";
+    recordsSinceCompaction++;
+    wake.notify_one();
+
+    if (options.compactEvery > 0 && recordsSinceCompaction >= options.compactEvery) {
+        std::string error;
+        if (!compactLocked(lock, error)) {
+            SLOG_WARN("journal", "Compaction failed, journal keeps growing: " << error);
+        }
+    }
+}
+
+void EditJournal::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            break;  // Stopping with nothing left to write
+        }
+
+        // Group commit: records appended in the meantime share this write and fsync
+        if (!stopping && !flushRequested && options.groupCommitMs > 0) {
+            wake.wait_for(lock, std::chrono::milliseconds(options.groupCommitMs),
+                          [this]() { return stopping || flushRequested; });
+        }
+
+        std::string batch;
+        batch.swap(pending);
+        uint32_t batchEnd = lastSequence;
+        flushRequested = false;
+        writing = true;
+        lock.unlock();
+        bool ok = std::fwrite(batch.data(), 1, batch.size(), file) == batch.size() && std::fflush(file) == 0 &&
+                  (!options.fsync || syncFile(file));
+        lock.lock();
+        writing = false;
+
+        if (ok) {
+            durableSequence = batchEnd;
+        } else if (!failed) {
+            failed = true;
+            SLOG_ERROR("journal", "Cannot write " << journalPath << ", further edits are not journaled");
+        }
+        durable.notify_all();
+    }
+    durable.notify_all();
+}
+
+bool EditJournal::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!file) {
+        return !failed;
+    }
+    uint32_t target = lastSequence;
+    flushRequested = true;
+    wake.notify_one();
+    durable.wait(lock, [&]() { return durableSequence >= target || failed; });
+    return !failed;
+}
+
+bool EditJournal::compact(std::string& error) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!file || !scheduler) {
+        error = "journal is not open";
+        return false;
+    }
+    return compactLocked(lock, error);
+}
+
+bool EditJournal::compactLocked(std::unique_lock<std::mutex>& lock, std::string& error) {
+    durable.wait(lock, [this]() { return !writing; });
+
+    // The snapshot records how far it goes, so a crash before the journal is
+    // emptied only means replaying records that are then skipped
+    if (!Snapshot::save(snapshotPath, *scheduler, error, lastSequence)) {
+        return false;
+    }
+    if (options.fsync && !syncPath(snapshotPath)) {
+        error = "cannot flush " + snapshotPath;
+        return false;
+    }
+
+    pending.clear();
+    file = std::freopen(journalPath.c_str(), "wb", file);
+    if (!file || (options.fsync && !syncFile(file))) {
+        failed = true;
+        error = "cannot reset " + journalPath;
+        return false;
+    }
+    durableSequence = lastSequence;
+    recordsSinceCompaction = 0;
+    durable.notify_all();
+    SLOG_DEBUG("journal", "Compacted into " << snapshotPath << " at record " << lastSequence);
+    return true;
+}
+
+size_t EditJournal::getReplayedRecords() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return replayedRecords;
+}
+
+size_t EditJournal::getRecordsSinceCompaction() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recordsSinceCompaction;
+}
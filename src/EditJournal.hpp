@@ -0,0 +1,88 @@
+#ifndef EDIT_JOURNAL_HPP
+#define EDIT_JOURNAL_HPP
+
+#include "Scheduler.hpp"
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+struct JournalOptions {
+    int groupCommitMs = 5;      // How long the writer waits for more records to share one fsync
+    size_t compactEvery = 1000; // Records after which the journal is folded into the snapshot (0 = never)
+    bool fsync = true;          // False leaves durability to the OS (benchmarks, throwaway sessions)
+};
+
+// Write-ahead log of the scheduler's input changes, next to a snapshot that holds
+// everything up to some point. Each change is appended as one line
+//
+//   <sequence> <checksum> <record>
+//
+// where the record uses the escaped instance file syntax for additions plus
+// remove-course, remove-teacher, remove-section, remove-requirement <index>,
+// remove-preference <index>, assign <teacher> <course> and clear. A background
+// writer batches the appends made within groupCommitMs into one write and fsync.
+// Every compactEvery records the scheduler is saved as the new snapshot and the
+// journal starts over. Opening restores the snapshot and replays the records
+// newer than it; a torn or corrupt tail left by a crash is cut off, while a
+// record that no longer applies fails the open.
+class EditJournal {
+public:
+    explicit EditJournal(const JournalOptions& options = JournalOptions());
+    ~EditJournal();
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // Loads the snapshot (a missing one means an empty term), replays the journal
+    // and starts recording the scheduler's changes. The scheduler must outlive
+    // the journal or be detached by close() first.
+    bool open(const std::string& snapshotPath, const std::string& journalPath, Scheduler& scheduler,
+              std::string& error);
+
+    // Makes every record durable and stops recording
+    void close();
+    bool isOpen() const;
+
+    // Blocks until every record appended so far is on disk
+    bool sync();
+
+    // Saves the scheduler as the snapshot and empties the journal
+    bool compact(std::string& error);
+
+    size_t getReplayedRecords() const;
+    size_t getRecordsSinceCompaction() const;
+
+private:
+    JournalOptions options;
+    std::string snapshotPath;
+    std::string journalPath;
+    Scheduler* scheduler = nullptr;
+
+    // Shared with the writer thread
+    mutable std::mutex mutex;
+    std::condition_variable wake;     // Records queued or shutdown requested
+    std::condition_variable durable;  // A batch reached the disk
+    std::thread writer;
+    std::FILE* file = nullptr;
+    std::string pending;              // Lines not yet handed to the OS
+    uint32_t lastSequence = 0;        // Last record appended
+    uint32_t durableSequence = 0;     // Last record known to be on disk
+    bool writing = false;             // Writer is writing a batch outside the lock
+    bool flushRequested = false;      // sync() is waiting, skip the group commit delay
+    bool stopping = false;
+    bool failed = false;              // A write or fsync failed; appends are dropped
+
+    size_t replayedRecords = 0;
+    size_t recordsSinceCompaction = 0;
+
+    void append(const ModelChange& change);
+    void run();
+    bool replay(uint32_t after, Scheduler& scheduler, std::string& error);
+    bool compactLocked(std::unique_lock<std::mutex>& lock, std::string& error);
+};
+
+#endif // EDIT_JOURNAL_HPP
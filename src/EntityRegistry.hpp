@@ -0,0 +1,96 @@
+#ifndef ENTITY_REGISTRY_HPP
+#define ENTITY_REGISTRY_HPP
+
+#include "Models.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+// Hands out dense handles for one kind of entity and finds entities by handle,
+// by pointer or by key (course code, teacher or section id) in O(1). Keys are
+// unique; the key index holds views into the entities' own strings, which never
+// change. Handles of removed entities are not reused until clear(), so a handle
+// never names two different entities.
+template <typename T>
+class EntityRegistry {
+public:
+    using KeyFunction = const std::string& (T::*)() const;
+
+    explicit EntityRegistry(KeyFunction key) : key(key) {}
+
+    // Gives the entity the next handle; false if it is already held or its key is taken
+    bool add(const Ref<T>& entity) {
+        if (contains(entity.get())) {
+            return false;
+        }
+        std::string_view name = ((*entity).*key)();
+        if (!byKey.emplace(name, static_cast<EntityHandle>(slots.size())).second) {
+            return false;
+        }
+        entity->setHandle(static_cast<EntityHandle>(slots.size()));
+        slots.push_back(entity);
+        live++;
+        return true;
+    }
+
+    // The entity loses its handle; copies made from it keep theirs
+    bool remove(const T* entity) {
+        if (!contains(entity)) {
+            return false;
+        }
+        EntityHandle handle = entity->getHandle();
+        byKey.erase(((*entity).*key)());
+        slots[handle]->setHandle(NO_HANDLE);
+        slots[handle].reset();
+        live--;
+        return true;
+    }
+
+    bool contains(const T* entity) const {
+        EntityHandle handle = entity ? entity->getHandle() : NO_HANDLE;
+        return handle < slots.size() && slots[handle].get() == entity;
+    }
+
+    // nullptr for a handle that was never given out or whose entity was removed
+    Ref<T> get(EntityHandle handle) const {
+        return handle < slots.size() ? slots[handle] : nullptr;
+    }
+
+    Ref<T> find(std::string_view name) const {
+        auto it = byKey.find(name);
+        return it != byKey.end() ? slots[it->second] : nullptr;
+    }
+
+    EntityHandle findHandle(std::string_view name) const {
+        auto it = byKey.find(name);
+        return it != byKey.end() ? it->second : NO_HANDLE;
+    }
+
+    // Live entities, and one past the largest handle given out (for handle-indexed tables)
+    size_t size() const { return live; }
+    size_t handleBound() const { return slots.size(); }
+
+    void reserve(size_t count) {
+        slots.reserve(count);
+        byKey.reserve(count);
+    }
+
+    void clear() {
+        for (const auto& entity : slots) {
+            if (entity) entity->setHandle(NO_HANDLE);
+        }
+        slots.clear();
+        byKey.clear();
+        live = 0;
+    }
+
+private:
+    KeyFunction key;
+    std::vector<Ref<T>> slots;
+    std::unordered_map<std::string_view, EntityHandle> byKey;
+    size_t live = 0;
+};
+
+#endif // ENTITY_REGISTRY_HPP
@@ -0,0 +1,355 @@
+#include "InstanceFile.hpp"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+
+std::string lowercase(std::string text) {
+    for (auto& c : text) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+// Whitespace separated fields of one record, undoing the escaping when asked
+class FieldReader {
+public:
+    FieldReader(const std::string& line, bool escaped) : in(line), escaped(escaped) {}
+
+    FieldReader& operator>>(std::string& text) {
+        if (in >> text && escaped && !InstanceFile::unescapeField(text, text)) {
+            in.setstate(std::ios::failbit);
+        }
+        return *this;
+    }
+
+    template <typename T>
+    FieldReader& operator>>(T& value) {
+        in >> value;
+        return *this;
+    }
+
+    explicit operator bool() const { return !in.fail(); }
+
+    // A name: the rest of the line without surrounding blanks, or the next field
+    std::string name() {
+        std::string rest;
+        if (escaped) {
+            if (!(in >> rest) || !InstanceFile::unescapeField(rest, rest)) {
+                rest.clear();
+            }
+            return rest;
+        }
+        std::getline(in, rest);
+        size_t first = rest.find_first_not_of(" \t");
+        size_t last = rest.find_last_not_of(" \t\r");
+        return first == std::string::npos ? "" : rest.substr(first, last - first + 1);
+    }
+
+private:
+    std::istringstream in;
+    bool escaped;
+};
+
+// How journals written before pins could omit the time spelled a missing one
+const char* const NO_TIME = "-1:-1";
+
+bool parseTime(const std::string& text, int& hour, int& minute) {
+    char colon = 0;
+    std::istringstream in(text);
+    if (!(in >> hour >> colon >> minute) || colon != ':') {
+        return false;
+    }
+    return hour >= 0 && hour <= 23 && minute >= 0 && minute <= 59;
+}
+
+std::string formatTime(int hour, int minute) {
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "%02d:%02d", hour, minute);
+    return buffer;
+}
+
+std::string field(const std::string& text, bool escaped) {
+    return escaped ? InstanceFile::escapeField(text) : text;
+}
+
+std::string courseToken(const std::string& courseCode, bool escaped) {
+    return courseCode.empty() ? "*" : field(courseCode, escaped);
+}
+
+// Parses one record, returns an empty string or the reason it was rejected
+std::string readRecord(const std::string& kind, FieldReader& fields, Scheduler& scheduler) {
+    if (kind == "course") {
+        std::string code;
+        int credits = 0;
+        if (!(fields >> code >> credits)) return "expected: course <code> <credits> <name>";
+        if (!scheduler.addCourse(makeRef<Course>(code, fields.name(), credits))) {
+            return "duplicate course " + code;
+        }
+    } else if (kind == "teacher") {
+        std::string id;
+        if (!(fields >> id)) return "expected: teacher <id> <name>";
+        if (!scheduler.addTeacher(makeRef<Teacher>(id, fields.name()))) {
+            return "duplicate teacher " + id;
+        }
+    } else if (kind == "section") {
+        std::string id, courseCode, teacherId;
+        int minutes = 0;
+        if (!(fields >> id >> courseCode >> teacherId >> minutes) || minutes <= 0) {
+            return "expected: section <id> <course> <teacher> <minutes>";
+        }
+        if (scheduler.findSection(id)) return "duplicate section " + id;
+        auto course = scheduler.findCourse(courseCode);
+        auto teacher = scheduler.findTeacher(teacherId);
+        if (!course) return "unknown course " + courseCode;
+        if (!teacher) return "unknown teacher " + teacherId;
+        scheduler.addSection(makeRef<Section>(id, course, teacher, TimeSlot(minutes)));
+    } else if (kind == "pin") {
+        std::string sectionId, dayText, timeText;
+        TimeSlot::Day day;
+        int hour = -1, minute = -1;
+        if (!(fields >> sectionId >> dayText) || !InstanceFile::parseDay(dayText, day) ||
+            (fields >> timeText && timeText != NO_TIME && !parseTime(timeText, hour, minute))) {
+            return "expected: pin <section> <mon..fri|any> [<HH:MM>]";
+        }
+        auto section = scheduler.findSection(sectionId);
+        if (!section) return "unknown section " + sectionId;
+        TimeSlot slot(section->getTimeSlot().getDurationMinutes(), day, hour, minute);
+        scheduler.addRequirement(std::make_shared<SectionTimeSlotRequirement>(section, slot));
+    } else if (kind == "require-time") {
+        std::string courseCode, dayText, timeText;
+        TimeSlot::Day day;
+        int hour, minute, minutes = 0;
+        if (!(fields >> courseCode >> dayText >> timeText >> minutes) || !InstanceFile::parseDay(dayText, day) ||
+            day == TimeSlot::UNASSIGNED || !parseTime(timeText, hour, minute) || minutes <= 0) {
+            return "expected: require-time <course> <mon..fri> <HH:MM> <minutes>";
+        }
+        auto course = scheduler.findCourse(courseCode);
+        if (!course) return "unknown course " + courseCode;
+        scheduler.addRequirement(std::make_shared<TimeSlotRequirement>(
+            course, TimeSlot(minutes, day, hour, minute)));
+    } else if (kind == "require-teacher") {
+        std::string courseCode, teacherId;
+        if (!(fields >> courseCode >> teacherId)) return "expected: require-teacher <course> <teacher>";
+        auto course = scheduler.findCourse(courseCode);
+        auto teacher = scheduler.findTeacher(teacherId);
+        if (!course) return "unknown course " + courseCode;
+        if (!teacher) return "unknown teacher " + teacherId;
+        scheduler.addRequirement(std::make_shared<TeacherRequirement>(course, teacher));
+    } else if (kind == "prefer-teacher" || kind == "avoid-teacher") {
+        std::string courseCode, teacherId;
+        double weight = 0.0;
+        if (!(fields >> courseCode >> teacherId >> weight)) {
+            return "expected: " + kind + " <course|*> <teacher> <weight>";
+        }
+        if (courseCode == "*") courseCode.clear();
+        scheduler.addPreference(kind == "prefer-teacher"
+            ? StudentPreference::preferTeacher(courseCode, teacherId, weight)
+            : StudentPreference::avoidTeacher(courseCode, teacherId, weight));
+    } else if (kind == "prefer-time" || kind == "avoid-time") {
+        std::string courseCode, dayText;
+        TimeSlot::Day day;
+        int fromHour = 0, toHour = 0;
+        double weight = 0.0;
+        if (!(fields >> courseCode >> dayText >> fromHour >> toHour >> weight) ||
+            !InstanceFile::parseDay(dayText, day) || fromHour >= toHour) {
+            return "expected: " + kind + " <course|*> <mon..fri|any> <fromHour> <toHour> <weight>";
+        }
+        if (courseCode == "*") courseCode.clear();
+        scheduler.addPreference(kind == "prefer-time"
+            ? StudentPreference::preferTimeSlot(courseCode, day, fromHour, toHour, weight)
+            : StudentPreference::avoidTimeSlot(courseCode, day, fromHour, toHour, weight));
+    } else if (kind == "no-early") {
+        int hour = 0;
+        double weight = 0.0;
+        if (!(fields >> hour >> weight)) return "expected: no-early <hour> <weight>";
+        scheduler.addPreference(StudentPreference::noEarlyClasses(hour, weight));
+    } else if (kind == "compact-days") {
+        double weight = 0.0;
+        if (!(fields >> weight)) return "expected: compact-days <weight>";
+        scheduler.addPreference(StudentPreference::compactDays(weight));
+    } else {
+        return "unknown record '" + kind + "'";
+    }
+    return "";
+}
+
+} // namespace
+
+bool InstanceFile::readLine(const std::string& line, Scheduler& scheduler, std::string& error, bool escaped) {
+    FieldReader fields(escaped ? line : line.substr(0, line.find('#')), escaped);
+    std::string kind;
+    if (!(fields >> kind)) {
+        return true;  // Blank line
+    }
+    error = readRecord(lowercase(kind), fields, scheduler);
+    return error.empty();
+}
+
+bool InstanceFile::read(std::istream& in, Scheduler& scheduler, std::string& error) {
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::string problem;
+        if (!readLine(line, scheduler, problem)) {
+            error = "line " + std::to_string(lineNumber) + ": " + problem;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InstanceFile::load(const std::string& path, Scheduler& scheduler, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    if (!read(file, scheduler, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+void InstanceFile::write(std::ostream& out, const Scheduler& scheduler) {
+    for (const auto& course : scheduler.getCourses()) {
+        out << courseRecord(*course) << "\n";
+    }
+    for (const auto& teacher : scheduler.getTeachers()) {
+        out << teacherRecord(*teacher) << "\n";
+    }
+    for (const auto& section : scheduler.getSections()) {
+        out << sectionRecord(*section) << "\n";
+    }
+    for (const auto& requirement : scheduler.getRequirements()) {
+        std::string record = requirementRecord(*requirement);
+        out << (record.empty() ? "# not representable: " + requirement->getDescription() : record) << "\n";
+    }
+    for (const auto& preference : scheduler.getPreferences()) {
+        out << preferenceRecord(preference) << "\n";
+    }
+}
+
+std::string InstanceFile::courseRecord(const Course& course, bool escaped) {
+    return "course " + field(course.getCode(), escaped) + " " + std::to_string(course.getCredits()) + " " +
+           field(course.getName(), escaped);
+}
+
+std::string InstanceFile::teacherRecord(const Teacher& teacher, bool escaped) {
+    return "teacher " + field(teacher.getId(), escaped) + " " + field(teacher.getName(), escaped);
+}
+
+std::string InstanceFile::sectionRecord(const Section& section, bool escaped) {
+    return "section " + field(section.getId(), escaped) + " " + field(section.getCourse()->getCode(), escaped) +
+           " " + field(section.getTeacher()->getId(), escaped) + " " +
+           std::to_string(section.getTimeSlot().getDurationMinutes());
+}
+
+std::string InstanceFile::requirementRecord(const Requirement& requirement, bool escaped) {
+    std::ostringstream out;
+    if (auto pin = dynamic_cast<const SectionTimeSlotRequirement*>(&requirement)) {
+        const TimeSlot& slot = pin->getTimeSlot();
+        out << "pin " << field(pin->getSection()->getId(), escaped) << " " << dayToken(slot.getDay());
+        if (slot.hasStartTime()) {
+            out << " " << formatTime(slot.getStartHour(), slot.getStartMinute());
+        }
+    } else if (auto time = dynamic_cast<const TimeSlotRequirement*>(&requirement)) {
+        const TimeSlot& slot = time->getTimeSlot();
+        out << "require-time " << field(time->getCourse()->getCode(), escaped) << " " << dayToken(slot.getDay()) << " "
+            << formatTime(slot.getStartHour(), slot.getStartMinute()) << " " << slot.getDurationMinutes();
+    } else if (auto teacher = dynamic_cast<const TeacherRequirement*>(&requirement)) {
+        out << "require-teacher " << field(teacher->getCourse()->getCode(), escaped) << " "
+            << field(teacher->getTeacher()->getId(), escaped);
+    }
+    return out.str();
+}
+
+std::string InstanceFile::preferenceRecord(const StudentPreference& preference, bool escaped) {
+    std::ostringstream out;
+    switch (preference.type) {
+        case StudentPreference::PREFER_TEACHER:
+        case StudentPreference::AVOID_TEACHER:
+            out << (preference.type == StudentPreference::PREFER_TEACHER ? "prefer-teacher " : "avoid-teacher ")
+                << courseToken(preference.courseCode, escaped) << " " << field(preference.teacherId, escaped) << " "
+                << preference.weight;
+            break;
+        case StudentPreference::PREFER_TIME_SLOT:
+        case StudentPreference::AVOID_TIME_SLOT:
+            out << (preference.type == StudentPreference::PREFER_TIME_SLOT ? "prefer-time " : "avoid-time ")
+                << courseToken(preference.courseCode, escaped) << " " << dayToken(preference.day) << " "
+                << preference.startHour << " " << preference.endHour << " " << preference.weight;
+            break;
+        case StudentPreference::NO_EARLY_CLASSES:
+            out << "no-early " << preference.startHour << " " << preference.weight;
+            break;
+        case StudentPreference::COMPACT_DAYS:
+            out << "compact-days " << preference.weight;
+            break;
+    }
+    return out.str();
+}
+
+std::string InstanceFile::escapeField(const std::string& text) {
+    static const char* digits = "0123456789ABCDEF";
+    std::string field;
+    for (char c : text) {
+        auto byte = static_cast<unsigned char>(c);
+        if (byte <= ' ' || byte == 0x7f || c == '%' || c == '#') {
+            field += '%';
+            field += digits[byte >> 4];
+            field += digits[byte & 0xf];
+        } else {
+            field += c;
+        }
+    }
+    return field;
+}
+
+bool InstanceFile::unescapeField(const std::string& field, std::string& text) {
+    std::string decoded;
+    for (size_t i = 0; i < field.size(); i++) {
+        if (field[i] != '%') {
+            decoded += field[i];
+            continue;
+        }
+        if (i + 2 >= field.size() || !std::isxdigit(static_cast<unsigned char>(field[i + 1])) ||
+            !std::isxdigit(static_cast<unsigned char>(field[i + 2]))) {
+            return false;
+        }
+        decoded += static_cast<char>(std::stoi(field.substr(i + 1, 2), nullptr, 16));
+        i += 2;
+    }
+    text = decoded;
+    return true;
+}
+
+bool InstanceFile::save(const std::string& path, const Scheduler& scheduler) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    write(file, scheduler);
+    return static_cast<bool>(file);
+}
+
+bool InstanceFile::parseDay(const std::string& text, TimeSlot::Day& day) {
+    static const char* tokens[] = { "mon", "tue", "wed", "thu", "fri", "any" };
+    std::string lower = lowercase(text);
+    for (int i = 0; i <= static_cast<int>(TimeSlot::UNASSIGNED); i++) {
+        if (lower == tokens[i]) {
+            day = static_cast<TimeSlot::Day>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* InstanceFile::dayToken(TimeSlot::Day day) {
+    static const char* tokens[] = { "mon", "tue", "wed", "thu", "fri", "any" };
+    return tokens[static_cast<int>(day)];
+}
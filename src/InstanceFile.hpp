@@ -0,0 +1,61 @@
+#ifndef INSTANCE_FILE_HPP
+#define INSTANCE_FILE_HPP
+
+#include "Scheduler.hpp"
+#include <string>
+#include <istream>
+#include <ostream>
+
+// Plain text description of a term, one record per line ('#' starts a comment).
+// Names run to the end of the line, days are mon..fri (or "any" for pins and
+// preferences), times are HH:MM and "*" as a course means every course. A pin
+// without a time only fixes the day.
+//
+//   course <code> <credits> <name>
+//   teacher <id> <name>
+//   section <id> <course> <teacher> <minutes>
+//   pin <section> <day> [<HH:MM>]                   (SectionTimeSlotRequirement)
+//   require-time <course> <day> <HH:MM> <minutes>   (TimeSlotRequirement)
+//   require-teacher <course> <teacher>              (TeacherRequirement)
+//   prefer-teacher|avoid-teacher <course> <teacher> <weight>
+//   prefer-time|avoid-time <course> <day> <fromHour> <toHour> <weight>
+//   no-early <hour> <weight>
+//   compact-days <weight>
+//
+// The escaped form (used by the edit journal) writes every id and name as one
+// field with '%', '#', blanks and control characters as %XX, so it has no comments
+// and a name is a single field like any other.
+class InstanceFile {
+public:
+    // Applies one record, resolving ids against what the scheduler holds. Blank and
+    // comment lines are accepted; `error` says why a record was rejected.
+    static bool readLine(const std::string& line, Scheduler& scheduler, std::string& error,
+                         bool escaped = false);
+    
+    // Adds the records to the scheduler. On failure `error` names the offending line
+    // and the scheduler holds everything read before it.
+    static bool read(std::istream& in, Scheduler& scheduler, std::string& error);
+    static bool load(const std::string& path, Scheduler& scheduler, std::string& error);
+
+    // Writes the scheduler's inputs back in the same format
+    static void write(std::ostream& out, const Scheduler& scheduler);
+    static bool save(const std::string& path, const Scheduler& scheduler);
+    
+    // The record line for one input, without the newline. Requirements the format
+    // cannot express give an empty string.
+    static std::string courseRecord(const Course& course, bool escaped = false);
+    static std::string teacherRecord(const Teacher& teacher, bool escaped = false);
+    static std::string sectionRecord(const Section& section, bool escaped = false);
+    static std::string requirementRecord(const Requirement& requirement, bool escaped = false);
+    static std::string preferenceRecord(const StudentPreference& preference, bool escaped = false);
+
+    // One field of the escaped form; unescapeField fails on a malformed %XX
+    static std::string escapeField(const std::string& text);
+    static bool unescapeField(const std::string& field, std::string& text);
+
+    // "mon".."fri" and "any"; returns false for anything else
+    static bool parseDay(const std::string& text, TimeSlot::Day& day);
+    static const char* dayToken(TimeSlot::Day day);
+};
+
+#endif // INSTANCE_FILE_HPP
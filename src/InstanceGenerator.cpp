@@ -0,0 +1,182 @@
+#include "InstanceGenerator.hpp"
+#include <random>
+#include <sstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Thin wrapper over mt19937 with distributions that behave the same everywhere
+class Random {
+public:
+    explicit Random(uint32_t seed) : engine(seed) {}
+
+    // Uniform in [lo, hi]
+    int range(int lo, int hi) {
+        if (hi <= lo) {
+            return lo;
+        }
+        uint32_t span = static_cast<uint32_t>(hi - lo) + 1;
+        return lo + static_cast<int>(engine() % span);
+    }
+
+    // Uniform in [0, 1)
+    double unit() {
+        return engine() / 4294967296.0;
+    }
+
+    bool chance(double probability) {
+        return unit() < probability;
+    }
+
+private:
+    std::mt19937 engine;
+};
+
+std::string numbered(const char* prefix, int number) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%s%03d", prefix, number);
+    return buffer;
+}
+
+std::string sectionSuffix(int index) {
+    if (index < 26) {
+        return std::string(1, static_cast<char>('A' + index));
+    }
+    return std::to_string(index + 1);
+}
+
+} // namespace
+
+InstanceGenerator::InstanceGenerator(const InstanceOptions& options) : options(options) {}
+
+const InstanceOptions& InstanceGenerator::getOptions() const {
+    return options;
+}
+
+void InstanceGenerator::populate(Scheduler& scheduler) const {
+    scheduler.clear();
+    Random random(options.seed);
+
+    std::vector<Ref<Teacher>> teachers;
+    int teacherCount = std::max(1, options.teachers);
+    for (int t = 0; t < teacherCount; t++) {
+        auto teacher = makeRef<Teacher>(numbered("T", t + 1), "Teacher " + std::to_string(t + 1));
+        teachers.push_back(teacher);
+        scheduler.addTeacher(teacher);
+    }
+
+    double totalWeight = 0.0;
+    for (const auto& entry : options.durationMix) {
+        totalWeight += entry.second;
+    }
+    auto pickDuration = [&]() {
+        double roll = random.unit() * totalWeight;
+        for (const auto& entry : options.durationMix) {
+            if (roll < entry.second) {
+                return entry.first;
+            }
+            roll -= entry.second;
+        }
+        return options.durationMix.empty() ? 60 : options.durationMix.back().first;
+    };
+
+    std::vector<Ref<Course>> courses;
+    std::vector<Ref<Section>> sections;
+    for (int c = 0; c < options.courses; c++) {
+        std::string code = numbered("CRS", c + 1);
+        auto course = makeRef<Course>(code, "Course " + std::to_string(c + 1), random.range(2, 4));
+        courses.push_back(course);
+        scheduler.addCourse(course);
+
+        // Sections of a course share a duration, each is taught by some teacher
+        int duration = pickDuration();
+        for (int s = 0; s < options.sectionsPerCourse; s++) {
+            auto teacher = teachers[random.range(0, teacherCount - 1)];
+            auto section = makeRef<Section>(code + "-" + sectionSuffix(s), course, teacher,
+                                                     TimeSlot(duration));
+            sections.push_back(section);
+            scheduler.addSection(section);
+        }
+    }
+
+    // Pin sections to non-overlapping slots between 8:00 and 18:00 so the instance stays feasible
+    const int dayStart = 8 * 60;
+    const int dayEnd = 18 * 60;
+    int dayCursor[5] = { dayStart, dayStart, dayStart, dayStart, dayStart };
+    for (const auto& section : sections) {
+        if (!random.chance(options.requirementDensity)) {
+            continue;
+        }
+
+        int duration = section->getTimeSlot().getDurationMinutes();
+        int firstDay = random.range(0, 4);
+        int day = -1;
+        for (int offset = 0; offset < 5; offset++) {
+            int candidate = (firstDay + offset) % 5;
+            if (dayCursor[candidate] + duration <= dayEnd) {
+                day = candidate;
+                break;
+            }
+        }
+        if (day < 0) {
+            break;  // The week is full
+        }
+
+        int start = dayCursor[day];
+        int gap = 30 * random.range(0, 2);
+        if (start + gap + duration <= dayEnd) {
+            start += gap;
+        }
+        dayCursor[day] = start + duration;
+
+        TimeSlot slot(duration, static_cast<TimeSlot::Day>(day), start / 60, start % 60);
+        scheduler.addRequirement(std::make_shared<SectionTimeSlotRequirement>(section, slot));
+    }
+
+    int preferenceCount = static_cast<int>(std::lround(options.courses * options.preferenceDensity));
+    for (int p = 0; p < preferenceCount && !courses.empty(); p++) {
+        const auto& course = courses[random.range(0, static_cast<int>(courses.size()) - 1)];
+        std::string code = course->getCode();
+        double weight = random.range(1, 5);
+        auto day = static_cast<TimeSlot::Day>(random.range(0, 4));
+
+        switch (random.range(0, 5)) {
+            case 0: {
+                const auto& courseSections = course->getSections();
+                auto teacher = courseSections.empty() ? teachers[0]
+                             : courseSections[random.range(0, static_cast<int>(courseSections.size()) - 1)]->getTeacher();
+                scheduler.addPreference(StudentPreference::preferTeacher(code, teacher->getId(), weight));
+                break;
+            }
+            case 1: {
+                auto teacher = teachers[random.range(0, teacherCount - 1)];
+                scheduler.addPreference(StudentPreference::avoidTeacher(code, teacher->getId(), weight));
+                break;
+            }
+            case 2:
+                scheduler.addPreference(StudentPreference::preferTimeSlot(code, day, 9, 12, weight));
+                break;
+            case 3:
+                scheduler.addPreference(StudentPreference::avoidTimeSlot(code, day, 14, 17, weight));
+                break;
+            case 4:
+                scheduler.addPreference(StudentPreference::noEarlyClasses(9, weight));
+                break;
+            default:
+                scheduler.addPreference(StudentPreference::compactDays(weight));
+                break;
+        }
+    }
+}
+
+std::string InstanceGenerator::describe(const Scheduler& scheduler) const {
+    std::ostringstream out;
+    out << scheduler.getCourses().size() << " courses, "
+        << scheduler.getTeachers().size() << " teachers, "
+        << scheduler.getSections().size() << " sections, "
+        << scheduler.getRequirements().size() << " pinned, "
+        << scheduler.getPreferences().size() << " preferences";
+    return out.str();
+}
@@ -0,0 +1,45 @@
+#ifndef INSTANCE_GENERATOR_HPP
+#define INSTANCE_GENERATOR_HPP
+
+#include "Scheduler.hpp"
+#include <vector>
+#include <utility>
+#include <string>
+#include <cstdint>
+
+// Shape of a synthetic term. The defaults give a small, comfortably feasible instance.
+struct InstanceOptions {
+    int courses = 10;
+    int teachers = 5;
+    int sectionsPerCourse = 2;
+
+    // Section durations in minutes with their relative weights
+    std::vector<std::pair<int, double>> durationMix = { {60, 0.4}, {75, 0.3}, {90, 0.3} };
+
+    double requirementDensity = 0.1;  // Fraction of sections pinned to a fixed time slot
+    double preferenceDensity = 0.2;   // Student preferences per course
+
+    uint32_t seed = 1;
+};
+
+// Builds reproducible random instances for benchmarks and stress tests. The same
+// options and seed give the same instance on every platform (only the raw output
+// of std::mt19937 is used, never the library specific distributions).
+class InstanceGenerator {
+public:
+    explicit InstanceGenerator(const InstanceOptions& options = InstanceOptions());
+
+    // Clears the scheduler and fills it with courses, teachers, sections,
+    // pinned-section requirements and preferences
+    void populate(Scheduler& scheduler) const;
+
+    // One line summary such as "20 courses, 10 teachers, 40 sections, 4 pinned, 4 preferences"
+    std::string describe(const Scheduler& scheduler) const;
+
+    const InstanceOptions& getOptions() const;
+
+private:
+    InstanceOptions options;
+};
+
+#endif // INSTANCE_GENERATOR_HPP
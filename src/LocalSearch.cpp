@@ -0,0 +1,344 @@
+#include "LocalSearch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+// ConflictGrid implementation
+ConflictGrid::ConflictGrid()
+    : occupancy(5 * SLOTS_PER_DAY, 0), conflicts(0) {}
+
+void ConflictGrid::cellRange(int startMinutes, int durationMinutes, int& first, int& last) {
+    // Round outwards so that a partial cell still counts as occupied
+    first = std::max(0, startMinutes / SLOT_MINUTES);
+    last = std::min(SLOTS_PER_DAY, (startMinutes + durationMinutes + SLOT_MINUTES - 1) / SLOT_MINUTES);
+}
+
+void ConflictGrid::add(TimeSlot::Day day, int startMinutes, int durationMinutes) {
+    if (day == TimeSlot::UNASSIGNED) return;
+    
+    int first, last;
+    cellRange(startMinutes, durationMinutes, first, last);
+    uint16_t* cells = &occupancy[static_cast<int>(day) * SLOTS_PER_DAY];
+    for (int i = first; i < last; i++) {
+        if (cells[i] > 0) conflicts++;
+        cells[i]++;
+    }
+}
+
+void ConflictGrid::remove(TimeSlot::Day day, int startMinutes, int durationMinutes) {
+    if (day == TimeSlot::UNASSIGNED) return;
+    
+    int first, last;
+    cellRange(startMinutes, durationMinutes, first, last);
+    uint16_t* cells = &occupancy[static_cast<int>(day) * SLOTS_PER_DAY];
+    for (int i = first; i < last; i++) {
+        cells[i]--;
+        if (cells[i] > 0) conflicts--;
+    }
+}
+
+long ConflictGrid::getConflicts() const {
+    return conflicts;
+}
+
+int ConflictGrid::overlapOf(TimeSlot::Day day, int startMinutes, int durationMinutes) const {
+    if (day == TimeSlot::UNASSIGNED) return 0;
+    
+    int first, last;
+    cellRange(startMinutes, durationMinutes, first, last);
+    const uint16_t* cells = &occupancy[static_cast<int>(day) * SLOTS_PER_DAY];
+    int overlap = 0;
+    for (int i = first; i < last; i++) {
+        overlap += cells[i] > 0 ? cells[i] - 1 : 0;
+    }
+    return overlap;
+}
+
+int ConflictGrid::overlapIfPlaced(TimeSlot::Day day, int startMinutes, int durationMinutes) const {
+    if (day == TimeSlot::UNASSIGNED) return 0;
+    
+    int first, last;
+    cellRange(startMinutes, durationMinutes, first, last);
+    const uint16_t* cells = &occupancy[static_cast<int>(day) * SLOTS_PER_DAY];
+    int overlap = 0;
+    for (int i = first; i < last; i++) {
+        overlap += cells[i];
+    }
+    return overlap;
+}
+
+void ConflictGrid::clear() {
+    std::fill(occupancy.begin(), occupancy.end(), 0);
+    conflicts = 0;
+}
+
+// LocalSearchSolver implementation
+LocalSearchSolver::LocalSearchSolver(const std::vector<Ref<Section>>& seedSections,
+                                     const std::vector<bool>& fixed,
+                                     const PreferenceScorer& scorer,
+                                     const LocalSearchOptions& options)
+    : sections(seedSections), fixed(fixed), scorer(scorer), options(options) {
+    
+    placements.reserve(sections.size());
+    for (size_t i = 0; i < sections.size(); i++) {
+        auto timeSlot = sections[i]->getTimeSlot();
+        Placement placement{timeSlot.getDay(),
+                            timeSlot.getStartHour() * 60 + timeSlot.getStartMinute(),
+                            timeSlot.getDurationMinutes()};
+        placements.push_back(placement);
+        grid.add(placement.day, placement.start, placement.duration);
+        
+        if (i >= fixed.size() || !fixed[i]) {
+            movable.push_back(i);
+        }
+    }
+}
+
+double LocalSearchSolver::cost(long conflicts, double preferenceScore) const {
+    return options.conflictPenalty * conflicts - preferenceScore;
+}
+
+std::shared_ptr<Schedule> LocalSearchSolver::buildSchedule(const std::vector<Placement>& placements) const {
+    auto schedule = std::make_shared<Schedule>();
+    for (size_t i = 0; i < sections.size(); i++) {
+        const Placement& placement = placements[i];
+        TimeSlot timeSlot(placement.duration, placement.day,
+                          placement.start / 60, placement.start % 60);
+        schedule->addSection(sections[i]->withTimeSlot(timeSlot));
+    }
+    return schedule;
+}
+
+LocalSearchResult LocalSearchSolver::run() {
+    LocalSearchResult result;
+    IncrementalPreferenceScore preference(scorer, sections);
+    
+    double currentCost = cost(grid.getConflicts(), preference.getScore());
+    double bestCost = currentCost;
+    std::vector<Placement> bestPlacements = placements;
+    result.bestConflicts = grid.getConflicts();
+    result.bestPreferenceScore = preference.getScore();
+    
+    if (movable.empty()) {
+        result.best = buildSchedule(bestPlacements);
+        return result;
+    }
+    
+    std::mt19937 rng(options.seed != 0 ? options.seed : std::random_device{}());
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.timeBudgetMs);
+    double temperature = options.initialTemperature;
+    int step = std::max(ConflictGrid::SLOT_MINUTES, options.startStepMinutes);
+    
+    // Move a section and keep the grid and preference score in sync
+    auto place = [&](size_t index, TimeSlot::Day day, int start) {
+        Placement& placement = placements[index];
+        grid.remove(placement.day, placement.start, placement.duration);
+        grid.add(day, start, placement.duration);
+        preference.applyMove(index, day, start);
+        placement.day = day;
+        placement.start = start;
+    };
+    
+    // Clamp a start so the section stays inside the allowed window
+    auto clampStart = [&](int start, int duration) {
+        int latestStart = std::max(options.earliestStartMinutes, options.latestEndMinutes - duration);
+        return std::min(std::max(start, options.earliestStartMinutes), latestStart);
+    };
+    
+    // Moves touch at most two sections; remember where they were for undo
+    struct Undo { size_t index; TimeSlot::Day day; int start; };
+    Undo undo[2];
+    int undoCount;
+    
+    while (true) {
+        if ((result.iterations & 255) == 0) {
+            if (std::chrono::steady_clock::now() >= deadline ||
+                (options.cancel && options.cancel->load(std::memory_order_relaxed))) {
+                result.stoppedEarly = true;
+                break;
+            }
+        }
+        if (options.maxIterations >= 0 && result.iterations >= options.maxIterations) {
+            break;
+        }
+        result.iterations++;
+        temperature = std::max(options.minTemperature, temperature * options.coolingRate);
+        
+        size_t a = movable[rng() % movable.size()];
+        const Placement current = placements[a];
+        undoCount = 0;
+        
+        int moveType = rng() % 3;
+        if (moveType == 0) {
+            // Shift a section earlier or later on the same day
+            int offset = (static_cast<int>(rng() % 8) - 4) * step;
+            if (offset == 0) offset = step;
+            TimeSlot::Day day = current.day == TimeSlot::UNASSIGNED ? TimeSlot::MONDAY : current.day;
+            int start = clampStart(current.start + offset, current.duration);
+            if (day == current.day && start == current.start) continue;
+            
+            undo[undoCount++] = Undo{a, current.day, current.start};
+            place(a, day, start);
+        } else if (moveType == 1) {
+            // Move a section to another day at the same time
+            int dayIndex = static_cast<int>(rng() % 5);
+            TimeSlot::Day day = static_cast<TimeSlot::Day>(dayIndex);
+            if (day == current.day) continue;
+            
+            undo[undoCount++] = Undo{a, current.day, current.start};
+            place(a, day, clampStart(current.start, current.duration));
+        } else {
+            // Swap the placements of two sections
+            size_t b = movable[rng() % movable.size()];
+            if (a == b) continue;
+            const Placement other = placements[b];
+            if (other.day == current.day && other.start == current.start) continue;
+            
+            undo[undoCount++] = Undo{a, current.day, current.start};
+            undo[undoCount++] = Undo{b, other.day, other.start};
+            place(a, other.day, clampStart(other.start, current.duration));
+            place(b, current.day, clampStart(current.start, other.duration));
+        }
+        
+        double newCost = cost(grid.getConflicts(), preference.getScore());
+        double delta = newCost - currentCost;
+        
+        if (delta <= 0 || uniform(rng) < std::exp(-delta / temperature)) {
+            // Accept the move
+            currentCost = newCost;
+            result.acceptedMoves++;
+            
+            if (newCost < bestCost) {
+                bestCost = newCost;
+                bestPlacements = placements;
+                result.bestConflicts = grid.getConflicts();
+                result.bestPreferenceScore = preference.getScore();
+            }
+        } else {
+            // Reject the move, undo in reverse order
+            for (int i = undoCount - 1; i >= 0; i--) {
+                place(undo[i].index, undo[i].day, undo[i].start);
+            }
+        }
+    }
+    
+    result.best = buildSchedule(bestPlacements);
+    return result;
+}
+
+// MinConflictsRepair implementation
+MinConflictsRepair::MinConflictsRepair(const std::vector<Ref<Section>>& sections,
+                                       const std::vector<bool>& fixed,
+                                       const RepairOptions& options)
+    : sections(sections), fixed(fixed), options(options), stepsTaken(0) {
+    
+    for (const auto& section : sections) {
+        auto timeSlot = section->getTimeSlot();
+        days.push_back(timeSlot.getDay());
+        starts.push_back(timeSlot.getStartHour() * 60 + timeSlot.getStartMinute());
+        grid.add(days.back(), starts.back(), timeSlot.getDurationMinutes());
+    }
+}
+
+bool MinConflictsRepair::isConflicted(size_t index) const {
+    return grid.overlapOf(days[index], starts[index], sections[index]->getTimeSlot().getDurationMinutes()) > 0;
+}
+
+int MinConflictsRepair::getStepsTaken() const {
+    return stepsTaken;
+}
+
+std::shared_ptr<Schedule> MinConflictsRepair::run() {
+    std::mt19937 rng(options.seed != 0 ? options.seed : std::random_device{}());
+    int step = std::max(ConflictGrid::SLOT_MINUTES, options.startStepMinutes);
+    
+    // Candidates that were conflicted when last checked; refilled by a full scan when exhausted
+    std::vector<size_t> conflicted;
+    
+    while (grid.getConflicts() > 0 && stepsTaken < options.maxSteps) {
+        // Pick a random conflicted section that is allowed to move
+        size_t chosen = sections.size();
+        while (chosen == sections.size()) {
+            if (conflicted.empty()) {
+                for (size_t i = 0; i < sections.size(); i++) {
+                    if ((i >= fixed.size() || !fixed[i]) && isConflicted(i)) {
+                        conflicted.push_back(i);
+                    }
+                }
+                // Only pinned sections are left in conflict, nothing we can do
+                if (conflicted.empty()) {
+                    return nullptr;
+                }
+            }
+            
+            size_t pick = rng() % conflicted.size();
+            size_t candidate = conflicted[pick];
+            conflicted[pick] = conflicted.back();
+            conflicted.pop_back();
+            
+            if (isConflicted(candidate)) {
+                chosen = candidate;
+            }
+        }
+        stepsTaken++;
+        
+        // Lift the section out and look for the least conflicted position
+        int duration = sections[chosen]->getTimeSlot().getDurationMinutes();
+        grid.remove(days[chosen], starts[chosen], duration);
+        
+        int latestStart = std::max(options.earliestStartMinutes, options.latestEndMinutes - duration);
+        int bestOverlap = -1;
+        int ties = 0;
+        TimeSlot::Day bestDay = days[chosen];
+        int bestStart = starts[chosen];
+        
+        for (int dayIndex = 0; dayIndex < 5; dayIndex++) {
+            TimeSlot::Day day = static_cast<TimeSlot::Day>(dayIndex);
+            for (int start = options.earliestStartMinutes; start <= latestStart; start += step) {
+                int overlap = grid.overlapIfPlaced(day, start, duration);
+                if (bestOverlap < 0 || overlap < bestOverlap) {
+                    bestOverlap = overlap;
+                    bestDay = day;
+                    bestStart = start;
+                    ties = 1;
+                } else if (overlap == bestOverlap) {
+                    // Reservoir sampling keeps every tied position equally likely
+                    ties++;
+                    if (rng() % ties == 0) {
+                        bestDay = day;
+                        bestStart = start;
+                    }
+                }
+            }
+        }
+        
+        days[chosen] = bestDay;
+        starts[chosen] = bestStart;
+        grid.add(bestDay, bestStart, duration);
+        
+        // Still conflicted sections go back into the pool
+        if (bestOverlap > 0) {
+            conflicted.push_back(chosen);
+        }
+    }
+    
+    if (grid.getConflicts() > 0) {
+        return nullptr;
+    }
+    
+    auto schedule = std::make_shared<Schedule>();
+    for (size_t i = 0; i < sections.size(); i++) {
+        TimeSlot timeSlot(sections[i]->getTimeSlot().getDurationMinutes(),
+                          days[i], starts[i] / 60, starts[i] % 60);
+        schedule->addSection(sections[i]->withTimeSlot(timeSlot));
+    }
+    
+    // The grid rounds to whole cells, so confirm with the exact check
+    if (schedule->hasConflicts()) {
+        return nullptr;
+    }
+    return schedule;
+}
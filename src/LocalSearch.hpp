@@ -0,0 +1,134 @@
+#ifndef LOCAL_SEARCH_HPP
+#define LOCAL_SEARCH_HPP
+
+#include "Models.hpp"
+#include "Preferences.hpp"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <atomic>
+
+// Occupancy counts for every day on a fixed minute grid. Keeping the number of
+// doubly booked cells up to date makes adding or removing a section cost
+// O(duration / SLOT_MINUTES), independent of how many sections are placed.
+class ConflictGrid {
+public:
+    static const int SLOT_MINUTES = 5;
+    static const int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;
+    
+    ConflictGrid();
+    
+    void add(TimeSlot::Day day, int startMinutes, int durationMinutes);
+    void remove(TimeSlot::Day day, int startMinutes, int durationMinutes);
+    
+    // Total number of doubly booked cells in the grid
+    long getConflicts() const;
+    
+    // Cells a placed section shares with others
+    int overlapOf(TimeSlot::Day day, int startMinutes, int durationMinutes) const;
+    
+    // Cells a section would share with others if it were placed here
+    int overlapIfPlaced(TimeSlot::Day day, int startMinutes, int durationMinutes) const;
+    
+    void clear();
+    
+private:
+    std::vector<uint16_t> occupancy;
+    long conflicts;
+    
+    // Grid cells covered by a time range, clamped to the day
+    static void cellRange(int startMinutes, int durationMinutes, int& first, int& last);
+};
+
+struct LocalSearchOptions {
+    int timeBudgetMs = 1000;            // Wall-clock budget for the search
+    long maxIterations = -1;            // Optional iteration cap (-1 = none)
+    double initialTemperature = 50.0;
+    double coolingRate = 0.9995;        // Temperature multiplier per iteration
+    double minTemperature = 0.01;
+    double conflictPenalty = 100.0;     // Cost of one doubly booked grid cell
+    int earliestStartMinutes = 8 * 60;  // Moves stay inside this window
+    int latestEndMinutes = 20 * 60;
+    int startStepMinutes = 15;          // Granularity of start times tried by moves
+    unsigned seed = 0;                  // 0 picks a random seed
+    const std::atomic<bool>* cancel = nullptr;  // Stops the search early when set
+};
+
+struct LocalSearchResult {
+    std::shared_ptr<Schedule> best;
+    long bestConflicts = 0;
+    double bestPreferenceScore = 0.0;
+    long iterations = 0;
+    long acceptedMoves = 0;
+    bool stoppedEarly = false;  // The clock or the cancel flag ended the search, not maxIterations
+};
+
+// Simulated annealing over section placements. Moves shift a section in time,
+// move it to another day or swap the placements of two sections. Each move is
+// evaluated incrementally with the conflict grid and the preference score.
+class LocalSearchSolver {
+public:
+    // fixed[i] marks sections that must not move (e.g. pinned by a requirement)
+    LocalSearchSolver(const std::vector<Ref<Section>>& seedSections,
+                      const std::vector<bool>& fixed,
+                      const PreferenceScorer& scorer,
+                      const LocalSearchOptions& options = LocalSearchOptions());
+    
+    LocalSearchResult run();
+    
+private:
+    struct Placement {
+        TimeSlot::Day day;
+        int start;
+        int duration;
+    };
+    
+    std::vector<Ref<Section>> sections;
+    std::vector<bool> fixed;
+    const PreferenceScorer& scorer;
+    LocalSearchOptions options;
+    
+    std::vector<Placement> placements;
+    std::vector<size_t> movable;
+    ConflictGrid grid;
+    
+    double cost(long conflicts, double preferenceScore) const;
+    std::shared_ptr<Schedule> buildSchedule(const std::vector<Placement>& placements) const;
+};
+
+struct RepairOptions {
+    int maxSteps = 500;                 // Give up after this many moves
+    int earliestStartMinutes = 8 * 60;  // Candidate positions stay inside this window
+    int latestEndMinutes = 20 * 60;
+    int startStepMinutes = 15;
+    unsigned seed = 0;                  // 0 picks a random seed
+};
+
+// Min-conflicts repair: repeatedly pick a conflicted section and move it to the
+// (day, start) with the fewest conflicts, breaking ties randomly. Conflict
+// counts come from the same incremental grid as the local search.
+class MinConflictsRepair {
+public:
+    MinConflictsRepair(const std::vector<Ref<Section>>& sections,
+                       const std::vector<bool>& fixed,
+                       const RepairOptions& options = RepairOptions());
+    
+    // Returns a conflict-free schedule, or nullptr if the step budget ran out
+    std::shared_ptr<Schedule> run();
+    
+    int getStepsTaken() const;
+    
+private:
+    std::vector<Ref<Section>> sections;
+    std::vector<bool> fixed;
+    RepairOptions options;
+    
+    std::vector<TimeSlot::Day> days;
+    std::vector<int> starts;
+    ConflictGrid grid;
+    int stepsTaken;
+    
+    bool isConflicted(size_t index) const;
+};
+
+#endif // LOCAL_SEARCH_HPP 
@@ -0,0 +1,183 @@
+#include "Log.hpp"
+#include <cstdio>
+#include <cctype>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+std::atomic<int> Logger::threshold(static_cast<int>(LogLevel::INFO));
+
+namespace {
+
+struct Record {
+    LogLevel level;
+    const char* component;
+    std::string message;
+};
+
+void writeToStdout(LogLevel level, const char* component, const std::string& message) {
+    // No per-line flush, stdout is flushed on exit or by Logger::flush
+    std::fprintf(stdout, "[%s] %s: %s\n", Logger::levelName(level), component, message.c_str());
+}
+
+// Shared state of the sink and the optional background writer
+struct LogState {
+    std::mutex mutex;
+    std::condition_variable wake;     // Records queued or shutdown requested
+    std::condition_variable drained;  // Queue emptied by the writer
+    std::deque<Record> queue;
+    Logger::Sink sink = writeToStdout;
+    std::thread writer;
+    bool async = false;
+    bool stopping = false;
+    bool writing = false;             // Writer is delivering a batch outside the lock
+
+    ~LogState() {
+        stopWriter();
+    }
+
+    void startWriter() {
+        stopping = false;
+        writer = std::thread([this]() { run(); });
+    }
+
+    void stopWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!writer.joinable()) {
+                return;
+            }
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;  // Stopping with nothing left to write
+            }
+
+            // Deliver the whole batch without holding the lock so producers never wait on I/O
+            std::deque<Record> batch;
+            batch.swap(queue);
+            Logger::Sink target = sink;
+            writing = true;
+            lock.unlock();
+            for (const auto& record : batch) {
+                target(record.level, record.component, record.message);
+            }
+            lock.lock();
+            writing = false;
+            if (queue.empty()) {
+                drained.notify_all();
+            }
+        }
+        drained.notify_all();
+    }
+};
+
+LogState& state() {
+    static LogState instance;
+    return instance;
+}
+
+} // namespace
+
+void Logger::setLevel(LogLevel level) {
+    threshold.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() {
+    return static_cast<LogLevel>(threshold.load(std::memory_order_relaxed));
+}
+
+void Logger::setSink(Sink sink) {
+    flush();
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.sink = sink ? sink : Sink(writeToStdout);
+}
+
+void Logger::setAsync(bool async) {
+    LogState& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.async == async) {
+            return;
+        }
+        s.async = async;
+    }
+    if (async) {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.startWriter();
+    } else {
+        // The writer drains the queue before it exits
+        s.stopWriter();
+    }
+}
+
+bool Logger::isAsync() {
+    LogState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.async;
+}
+
+void Logger::flush() {
+    LogState& s = state();
+    {
+        std::unique_lock<std::mutex> lock(s.mutex);
+        if (s.writer.joinable()) {
+            s.drained.wait(lock, [&s]() { return s.queue.empty() && !s.writing; });
+        }
+    }
+    std::fflush(stdout);
+}
+
+void Logger::write(LogLevel level, const char* component, const std::string& message) {
+    LogState& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    if (s.async) {
+        s.queue.push_back(Record{level, component, message});
+        lock.unlock();
+        s.wake.notify_one();
+        return;
+    }
+    s.sink(level, component, message);
+}
+
+const char* Logger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        default:              return "OFF";
+    }
+}
+
+bool Logger::parseLevel(const std::string& name, LogLevel& level) {
+    std::string lower;
+    for (char c : name) {
+        lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    const LogLevel levels[] = { LogLevel::TRACE, LogLevel::DEBUG, LogLevel::INFO,
+                                LogLevel::WARN, LogLevel::ERROR, LogLevel::OFF };
+    for (LogLevel candidate : levels) {
+        std::string candidateName = levelName(candidate);
+        for (auto& c : candidateName) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (lower == candidateName) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,79 @@
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <string>
+#include <sstream>
+#include <functional>
+#include <atomic>
+
+enum class LogLevel {
+    TRACE = 0,  // Per-schedule dumps and other bulk output
+    DEBUG = 1,  // Solver statistics
+    INFO  = 2,
+    WARN  = 3,
+    ERROR = 4,
+    OFF   = 5
+};
+
+// Levels below this are compiled out entirely (build with -DSCHEDULER_LOG_MIN_LEVEL=2
+// to drop TRACE and DEBUG statements from the binary)
+#ifndef SCHEDULER_LOG_MIN_LEVEL
+#define SCHEDULER_LOG_MIN_LEVEL 0
+#endif
+
+// Leveled logger with a runtime threshold. Messages are only formatted when their
+// level is enabled, so a disabled statement costs a single relaxed load and branch.
+// Records go to the sink directly, or through a background thread when async.
+class Logger {
+public:
+    using Sink = std::function<void(LogLevel level, const char* component, const std::string& message)>;
+
+    static void setLevel(LogLevel level);
+    static LogLevel getLevel();
+
+    static bool enabled(LogLevel level) {
+        return static_cast<int>(level) >= SCHEDULER_LOG_MIN_LEVEL &&
+               static_cast<int>(level) >= threshold.load(std::memory_order_relaxed);
+    }
+
+    // Replace where records go (default: "[LEVEL] component: message" on stdout).
+    // An empty sink restores the default.
+    static void setSink(Sink sink);
+
+    // Hand records to a background thread so the caller never waits on I/O.
+    // Turning it off drains the queue first.
+    static void setAsync(bool async);
+    static bool isAsync();
+
+    // Block until every queued record has reached the sink
+    static void flush();
+
+    static void write(LogLevel level, const char* component, const std::string& message);
+
+    static const char* levelName(LogLevel level);
+
+    // Parses "trace", "debug", "info", "warn", "error" or "off" (any case); returns false otherwise
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+private:
+    static std::atomic<int> threshold;
+};
+
+// Usage: SLOG_DEBUG("sat", numVars << " vars, " << numClauses << " clauses");
+// The component must be a string literal, records keep the pointer rather than a copy.
+#define SCHEDULER_LOG(level, component, expr)                           \
+    do {                                                                \
+        if (Logger::enabled(level)) {                                   \
+            std::ostringstream schedulerLogStream;                      \
+            schedulerLogStream << expr;                                 \
+            Logger::write(level, component, schedulerLogStream.str());  \
+        }                                                               \
+    } while (0)
+
+#define SLOG_TRACE(component, expr) SCHEDULER_LOG(LogLevel::TRACE, component, expr)
+#define SLOG_DEBUG(component, expr) SCHEDULER_LOG(LogLevel::DEBUG, component, expr)
+#define SLOG_INFO(component, expr)  SCHEDULER_LOG(LogLevel::INFO, component, expr)
+#define SLOG_WARN(component, expr)  SCHEDULER_LOG(LogLevel::WARN, component, expr)
+#define SLOG_ERROR(component, expr) SCHEDULER_LOG(LogLevel::ERROR, component, expr)
+
+#endif // LOG_HPP
@@ -0,0 +1,70 @@
+#include "MappedFile.hpp"
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        error = "cannot stat " + path;
+        return false;
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length == 0) {
+        ::close(fd);
+        begin = "";
+        return true;
+    }
+    void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference
+    if (address != MAP_FAILED) {
+        madvise(address, length, MADV_SEQUENTIAL);
+        begin = static_cast<const char*>(address);
+        mapped = true;
+        return true;
+    }
+    length = 0;
+#endif
+
+    // No mmap (or it failed, e.g. on a pipe): read the whole file instead
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    begin = fallback.empty() ? "" : fallback.data();
+    length = fallback.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<char*>(begin), length);
+    }
+#endif
+    fallback.clear();
+    fallback.shrink_to_fit();
+    begin = nullptr;
+    length = 0;
+    mapped = false;
+}
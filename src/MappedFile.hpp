@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read-only view of a whole file. Maps it into memory where the platform allows,
+// otherwise reads it into a buffer; either way the bytes stay valid until close().
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(begin, length); }
+
+    // True when [text, text + size) lies inside the file's bytes
+    bool contains(std::string_view text) const {
+        return text.data() >= begin && text.data() + text.size() <= begin + length;
+    }
+
+private:
+    const char* begin = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::vector<char> fallback;  // Used when mapping is not available
+};
+
+#endif // MAPPED_FILE_HPP
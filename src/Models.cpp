@@ -1,46 +1,22 @@
 #include "Models.hpp"
+#include "Trace.hpp"
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
 
 // TimeSlot implementation
-TimeSlot::TimeSlot(int durationMinutes, Day day, int startHour, int startMinute)
-    : day(day), startHour(startHour), startMinute(startMinute), durationMinutes(durationMinutes) {}
-
-TimeSlot::Day TimeSlot::getDay() const {
-    return day;
-}
-
-int TimeSlot::getStartHour() const {
-    return startHour;
-}
-
-int TimeSlot::getStartMinute() const {
-    return startMinute;
-}
-
-int TimeSlot::getDurationMinutes() const {
-    return durationMinutes;
-}
-
-bool TimeSlot::hasStartTime() const {
-    return startHour >= 0 && startMinute >= 0;
-}
-
-bool TimeSlot::hasDay() const {
-    return day != UNASSIGNED;
-}
-
-std::shared_ptr<TimeSlot> TimeSlot::withStartTime(int startHour, int startMinute) const {
-    return std::make_shared<TimeSlot>(durationMinutes, day, startHour, startMinute);
+TimeSlot TimeSlot::withStartTime(int startHour, int startMinute) const {
+    return TimeSlot(durationMinutes, getDay(), startHour, startMinute);
 }
 
-std::shared_ptr<TimeSlot> TimeSlot::withDay(Day day) const {
-    return std::make_shared<TimeSlot>(durationMinutes, day, startHour, startMinute);
+TimeSlot TimeSlot::withDay(Day day) const {
+    TimeSlot moved = *this;
+    moved.day = static_cast<uint8_t>(day);
+    return moved;
 }
 
-std::shared_ptr<TimeSlot> TimeSlot::withDayAndTime(Day day, int startHour, int startMinute) const {
-    return std::make_shared<TimeSlot>(durationMinutes, day, startHour, startMinute);
+TimeSlot TimeSlot::withDayAndTime(Day day, int startHour, int startMinute) const {
+    return TimeSlot(durationMinutes, day, startHour, startMinute);
 }
 
 std::string TimeSlot::toString() const {
@@ -60,6 +36,8 @@ std::string TimeSlot::toString() const {
     }
     
     // Format hours in 12-hour format
+    int startHour = getStartHour();
+    int startMinute = getStartMinute();
     int hour12 = (startHour > 12) ? (startHour - 12) : startHour;
     if (hour12 == 0) hour12 = 12;
     
@@ -106,10 +84,10 @@ bool TimeSlot::overlaps(const TimeSlot& other) const {
         return false;
     }
     
-    int thisStartTotalMinutes = startHour * 60 + startMinute;
+    int thisStartTotalMinutes = startMinutes;
     int thisEndTotalMinutes = thisStartTotalMinutes + durationMinutes;
     
-    int otherStartTotalMinutes = other.startHour * 60 + other.startMinute;
+    int otherStartTotalMinutes = other.startMinutes;
     int otherEndTotalMinutes = otherStartTotalMinutes + other.durationMinutes;
     
     return (thisStartTotalMinutes < otherEndTotalMinutes && thisEndTotalMinutes > otherStartTotalMinutes);
@@ -119,37 +97,44 @@ bool TimeSlot::overlaps(const TimeSlot& other) const {
 Teacher::Teacher(const std::string& id, const std::string& name)
     : id(id), name(name) {}
 
-std::string Teacher::getId() const {
+const std::string& Teacher::getId() const {
     return id;
 }
 
-std::string Teacher::getName() const {
+const std::string& Teacher::getName() const {
     return name;
 }
 
-const std::vector<std::shared_ptr<Course>>& Teacher::getCourses() const {
+const std::vector<Ref<Course>>& Teacher::getCourses() const {
     return courses;
 }
 
-void Teacher::addCourse(std::shared_ptr<Course> course) {
+void Teacher::addCourse(Ref<Course> course) {
     if (std::find(courses.begin(), courses.end(), course) == courses.end()) {
         courses.push_back(course);
     }
 }
 
-void Teacher::removeCourse(std::shared_ptr<Course> course) {
+void Teacher::removeCourse(Ref<Course> course) {
     courses.erase(std::remove(courses.begin(), courses.end(), course), courses.end());
 }
 
+bool Teacher::isSameAs(const Teacher& other) const {
+    if (handle != NO_HANDLE && other.handle != NO_HANDLE) {
+        return handle == other.handle;
+    }
+    return this == &other || id == other.id;
+}
+
 // Course implementation
 Course::Course(const std::string& code, const std::string& name, int credits)
     : code(code), name(name), credits(credits) {}
 
-std::string Course::getCode() const {
+const std::string& Course::getCode() const {
     return code;
 }
 
-std::string Course::getName() const {
+const std::string& Course::getName() const {
     return name;
 }
 
@@ -157,81 +142,85 @@ int Course::getCredits() const {
     return credits;
 }
 
-const std::vector<std::shared_ptr<Section>>& Course::getSections() const {
+const std::vector<Ref<Section>>& Course::getSections() const {
     return sections;
 }
 
-void Course::addSection(std::shared_ptr<Section> section) {
+void Course::addSection(Ref<Section> section) {
     if (std::find(sections.begin(), sections.end(), section) == sections.end()) {
         sections.push_back(section);
     }
 }
 
-void Course::removeSection(std::shared_ptr<Section> section) {
+void Course::removeSection(Ref<Section> section) {
     sections.erase(std::remove(sections.begin(), sections.end(), section), sections.end());
 }
 
+bool Course::isSameAs(const Course& other) const {
+    if (handle != NO_HANDLE && other.handle != NO_HANDLE) {
+        return handle == other.handle;
+    }
+    return this == &other || code == other.code;
+}
+
 // Section implementation
-Section::Section(const std::string& id, std::shared_ptr<Course> course, 
-                 std::shared_ptr<Teacher> teacher, std::shared_ptr<TimeSlot> timeSlot)
+Section::Section(const std::string& id, Ref<Course> course, 
+                 Ref<Teacher> teacher, const TimeSlot& timeSlot)
     : id(id), course(course), teacher(teacher), timeSlot(timeSlot) {}
 
-std::string Section::getId() const {
+const std::string& Section::getId() const {
     return id;
 }
 
-std::shared_ptr<Course> Section::getCourse() const {
-    return course;
+void Section::setTeacher(Ref<Teacher> teacher) {
+    this->teacher = teacher;
 }
 
-std::shared_ptr<Teacher> Section::getTeacher() const {
-    return teacher;
+void Section::setTimeSlot(const TimeSlot& timeSlot) {
+    this->timeSlot = timeSlot;
 }
 
-std::shared_ptr<TimeSlot> Section::getTimeSlot() const {
-    return timeSlot;
+Ref<Section> Section::withStartTime(int startHour, int startMinute) const {
+    // Create a new Section with the assigned start time
+    return withTimeSlot(timeSlot.withStartTime(startHour, startMinute));
 }
 
-void Section::setTeacher(std::shared_ptr<Teacher> teacher) {
-    this->teacher = teacher;
+Ref<Section> Section::withTimeSlot(const TimeSlot& timeSlot) const {
+    auto placed = makeRef<Section>(*this);
+    placed->timeSlot = timeSlot;
+    return placed;
 }
 
-void Section::setTimeSlot(std::shared_ptr<TimeSlot> timeSlot) {
-    this->timeSlot = timeSlot;
-}
-
-std::shared_ptr<Section> Section::withStartTime(int startHour, int startMinute) const {
-    // Create a new TimeSlot with the assigned start time
-    auto newTimeSlot = timeSlot->withStartTime(startHour, startMinute);
-    
-    // Create a new Section with the new TimeSlot
-    return std::make_shared<Section>(id, course, teacher, newTimeSlot);
+bool Section::isSameAs(const Section& other) const {
+    if (handle != NO_HANDLE && other.handle != NO_HANDLE) {
+        return handle == other.handle;
+    }
+    return this == &other || id == other.id;
 }
 
 // TimeSlotRequirement implementation
-TimeSlotRequirement::TimeSlotRequirement(std::shared_ptr<Course> course, std::shared_ptr<TimeSlot> timeSlot)
+TimeSlotRequirement::TimeSlotRequirement(Ref<Course> course, const TimeSlot& timeSlot)
     : course(course), timeSlot(timeSlot) {}
 
 bool TimeSlotRequirement::isSatisfied(const Schedule& schedule) const {
-    auto sections = schedule.getSectionsForCourse(course->getCode());
-    for (const auto& section : sections) {
-        auto sectionTimeSlot = section->getTimeSlot();
-        auto requiredTimeSlot = timeSlot;
+    for (const auto& section : schedule.getSectionsForCourse(*course)) {
+        const TimeSlot& sectionTimeSlot = section->getTimeSlot();
+        const TimeSlot& requiredTimeSlot = timeSlot;
         
         // Check if requirement specifies a day
-        if (requiredTimeSlot->hasDay()) {
+        if (requiredTimeSlot.hasDay()) {
             // If section doesn't have a day assigned or has a different day, it doesn't match
-            if (!sectionTimeSlot->hasDay() || sectionTimeSlot->getDay() != requiredTimeSlot->getDay()) {
+            if (!sectionTimeSlot.hasDay() || sectionTimeSlot.getDay() != requiredTimeSlot.getDay()) {
                 continue;
             }
         }
         
         // Check if requirement specifies a start time
-        if (requiredTimeSlot->hasStartTime()) {
+        if (requiredTimeSlot.hasStartTime()) {
             // If section doesn't have start time assigned or has a different start time, it doesn't match
-            if (!sectionTimeSlot->hasStartTime() || 
-                sectionTimeSlot->getStartHour() != requiredTimeSlot->getStartHour() ||
-                sectionTimeSlot->getStartMinute() != requiredTimeSlot->getStartMinute()) {
+            if (!sectionTimeSlot.hasStartTime() || 
+                sectionTimeSlot.getStartHour() != requiredTimeSlot.getStartHour() ||
+                sectionTimeSlot.getStartMinute() != requiredTimeSlot.getStartMinute()) {
                 continue;
             }
         }
@@ -243,17 +232,16 @@ bool TimeSlotRequirement::isSatisfied(const Schedule& schedule) const {
 }
 
 std::string TimeSlotRequirement::getDescription() const {
-    return "Course " + course->getCode() + " must be in time slot " + timeSlot->toString();
+    return "Course " + course->getCode() + " must be in time slot " + timeSlot.toString();
 }
 
 // TeacherRequirement implementation
-TeacherRequirement::TeacherRequirement(std::shared_ptr<Course> course, std::shared_ptr<Teacher> teacher)
+TeacherRequirement::TeacherRequirement(Ref<Course> course, Ref<Teacher> teacher)
     : course(course), teacher(teacher) {}
 
 bool TeacherRequirement::isSatisfied(const Schedule& schedule) const {
-    auto sections = schedule.getSectionsForCourse(course->getCode());
-    for (const auto& section : sections) {
-        if (section->getTeacher()->getId() == teacher->getId()) {
+    for (const auto& section : schedule.getSectionsForCourse(*course)) {
+        if (section->getTeacher()->isSameAs(*teacher)) {
             return true;
         }
     }
@@ -265,29 +253,29 @@ std::string TeacherRequirement::getDescription() const {
 }
 
 // SectionTimeSlotRequirement implementation
-SectionTimeSlotRequirement::SectionTimeSlotRequirement(std::shared_ptr<Section> section, std::shared_ptr<TimeSlot> timeSlot)
+SectionTimeSlotRequirement::SectionTimeSlotRequirement(Ref<Section> section, const TimeSlot& timeSlot)
     : section(section), timeSlot(timeSlot) {}
 
 bool SectionTimeSlotRequirement::isSatisfied(const Schedule& schedule) const {
-    for (const auto& scheduleSection : schedule.getSections()) {
-        // Find the matching section by ID
-        if (scheduleSection->getId() == section->getId()) {
-            auto sectionTimeSlot = scheduleSection->getTimeSlot();
+    for (const auto& scheduleSection : schedule.getSectionsForCourse(*section->getCourse())) {
+        // Find the placed copy of the section
+        if (scheduleSection->isSameAs(*section)) {
+            const TimeSlot& sectionTimeSlot = scheduleSection->getTimeSlot();
             
             // Check if requirement specifies a day
-            if (timeSlot->hasDay()) {
+            if (timeSlot.hasDay()) {
                 // If section doesn't have a day assigned or has a different day, it doesn't match
-                if (!sectionTimeSlot->hasDay() || sectionTimeSlot->getDay() != timeSlot->getDay()) {
+                if (!sectionTimeSlot.hasDay() || sectionTimeSlot.getDay() != timeSlot.getDay()) {
                     return false;
                 }
             }
             
             // Check if requirement specifies a start time
-            if (timeSlot->hasStartTime()) {
+            if (timeSlot.hasStartTime()) {
                 // If section doesn't have start time assigned or has a different start time, it doesn't match
-                if (!sectionTimeSlot->hasStartTime() || 
-                    sectionTimeSlot->getStartHour() != timeSlot->getStartHour() ||
-                    sectionTimeSlot->getStartMinute() != timeSlot->getStartMinute()) {
+                if (!sectionTimeSlot.hasStartTime() || 
+                    sectionTimeSlot.getStartHour() != timeSlot.getStartHour() ||
+                    sectionTimeSlot.getStartMinute() != timeSlot.getStartMinute()) {
                     return false;
                 }
             }
@@ -302,48 +290,334 @@ bool SectionTimeSlotRequirement::isSatisfied(const Schedule& schedule) const {
 }
 
 std::string SectionTimeSlotRequirement::getDescription() const {
-    return "Section " + section->getId() + " must be in time slot " + timeSlot->toString();
+    return "Section " + section->getId() + " must be in time slot " + timeSlot.toString();
+}
+
+// SectionList implementation
+SectionList::const_iterator SectionList::begin() const {
+    return spine ? const_iterator(spine->chunks.data(), 0) : const_iterator();
+}
+
+SectionList::const_iterator SectionList::end() const {
+    return spine ? const_iterator(spine->chunks.data() + count / CHUNK_SIZE, count % CHUNK_SIZE)
+                 : const_iterator();
+}
+
+void SectionList::push_back(Ref<Section> section) {
+    if (count % CHUNK_SIZE == 0) {
+        writableSpine().chunks.push_back(makeRef<Chunk>());
+    }
+    writableChunk(count / CHUNK_SIZE).sections[count % CHUNK_SIZE] = std::move(section);
+    count++;
+}
+
+void SectionList::set(size_t index, Ref<Section> section) {
+    writableChunk(index / CHUNK_SIZE).sections[index % CHUNK_SIZE] = std::move(section);
+}
+
+std::vector<Ref<Section>> SectionList::toVector() const {
+    return std::vector<Ref<Section>>(begin(), end());
+}
+
+SectionList::Spine& SectionList::writableSpine() {
+    if (!spine) {
+        spine = makeRef<Spine>();
+    } else if (spine.use_count() > 1) {
+        spine = makeRef<Spine>(*spine);
+    }
+    return *spine;
+}
+
+SectionList::Chunk& SectionList::writableChunk(size_t chunkIndex) {
+    Ref<Chunk>& chunk = writableSpine().chunks[chunkIndex];
+    if (chunk.use_count() > 1) {
+        chunk = makeRef<Chunk>(*chunk);
+    }
+    return *chunk;
 }
 
 // Schedule implementation
+struct Schedule::KeyIndex {
+    struct Group {
+        std::string_view key;
+        uint32_t begin;
+        uint32_t end;
+    };
+    
+    // Slots grouped by entity, in schedule order within a group
+    std::vector<const Ref<Section>*> order;
+    
+    // One group per distinct entity in the schedule. When every entity is registered, groups
+    // are sorted by handle (handles[i] belongs to groups[i]) and byKey lists them by key;
+    // otherwise handles is empty and groups are sorted by key.
+    std::vector<Group> groups;
+    std::vector<EntityHandle> handles;
+    std::vector<uint32_t> byKey;
+    
+    // When the handles are packed (span at most twice the group count), dense[h - handles[0]]
+    // is the group of handle h plus one, or 0 if the schedule has none
+    std::vector<uint32_t> dense;
+};
+
 Schedule::Schedule() {}
 
-void Schedule::addSection(std::shared_ptr<Section> section) {
+// The copy starts without indexes; it builds its own when first asked
+Schedule::Schedule(const Schedule& other) : sections(other.sections) {}
+
+Schedule& Schedule::operator=(const Schedule& other) {
+    if (this != &other) {
+        dropIndexes();
+        sections = other.sections;
+    }
+    return *this;
+}
+
+Schedule::~Schedule() {
+    dropIndexes();
+}
+
+void Schedule::dropIndexes() {
+    delete courseIndex.exchange(nullptr, std::memory_order_acq_rel);
+    delete teacherIndex.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void Schedule::addSection(Ref<Section> section) {
     if (std::find(sections.begin(), sections.end(), section) == sections.end()) {
+        dropIndexes();
         sections.push_back(section);
     }
 }
 
-void Schedule::removeSection(std::shared_ptr<Section> section) {
-    sections.erase(std::remove(sections.begin(), sections.end(), section), sections.end());
+void Schedule::removeSection(Ref<Section> section) {
+    // Rare (editing, not solving), so the list is simply rebuilt without it
+    SectionList kept;
+    for (const auto& existing : sections) {
+        if (existing != section) {
+            kept.push_back(existing);
+        }
+    }
+    dropIndexes();
+    sections = kept;
 }
 
-const std::vector<std::shared_ptr<Section>>& Schedule::getSections() const {
+void Schedule::replaceSection(size_t index, Ref<Section> section) {
+    dropIndexes();
+    sections.set(index, section);
+}
+
+const SectionList& Schedule::getSections() const {
     return sections;
 }
 
-std::vector<std::shared_ptr<Section>> Schedule::getSectionsForCourse(const std::string& courseCode) const {
-    std::vector<std::shared_ptr<Section>> result;
-    for (const auto& section : sections) {
-        if (section->getCourse()->getCode() == courseCode) {
-            result.push_back(section);
+SectionSpan Schedule::getSectionsForCourse(const Course& course) const {
+    return lookup(courseIndex, &Section::getCourse, &Course::getCode, course);
+}
+
+SectionSpan Schedule::getSectionsForTeacher(const Teacher& teacher) const {
+    return lookup(teacherIndex, &Section::getTeacher, &Teacher::getId, teacher);
+}
+
+template <typename T>
+SectionSpan Schedule::lookup(std::atomic<KeyIndex*>& slot, const Ref<T>& (Section::*entityOf)() const,
+                             const std::string& (T::*keyOf)() const, const T& entity) const {
+    auto entityAt = [&](const Ref<Section>& section) -> const T& { return *((*section).*entityOf)(); };
+    
+    KeyIndex* index = slot.load(std::memory_order_acquire);
+    if (!index) {
+        auto built = std::make_unique<KeyIndex>();
+        built->order.resize(sections.size());
+        
+        bool registered = true;
+        for (const auto& section : sections) {
+            if (entityAt(section).getHandle() == NO_HANDLE) {
+                registered = false;
+                break;
+            }
         }
+        
+        if (registered) {
+            // Sort (handle, position) pairs: ties keep schedule order, and the index only
+            // grows with the entities this schedule actually uses
+            thread_local std::vector<std::pair<EntityHandle, uint32_t>> handled;
+            handled.clear();
+            for (const auto& section : sections) {
+                handled.emplace_back(entityAt(section).getHandle(), static_cast<uint32_t>(handled.size()));
+            }
+            std::sort(handled.begin(), handled.end());
+            for (uint32_t i = 0; i < handled.size(); i++) {
+                const Ref<Section>& section = sections[handled[i].second];
+                built->order[i] = &section;
+                if (built->handles.empty() || built->handles.back() != handled[i].first) {
+                    built->handles.push_back(handled[i].first);
+                    built->groups.push_back({(entityAt(section).*keyOf)(), i, i});
+                }
+                built->groups.back().end = i + 1;
+            }
+            
+            // Copies of a removed entity keep its handle, so a key can name two groups;
+            // ties go to the lower handle
+            built->byKey.resize(built->groups.size());
+            for (uint32_t group = 0; group < built->byKey.size(); group++) {
+                built->byKey[group] = group;
+            }
+            std::sort(built->byKey.begin(), built->byKey.end(), [&](uint32_t a, uint32_t b) {
+                const auto& first = built->groups[a];
+                const auto& second = built->groups[b];
+                return first.key != second.key ? first.key < second.key : a < b;
+            });
+            
+            if (!built->handles.empty()) {
+                size_t span = built->handles.back() - built->handles.front() + size_t(1);
+                if (span <= 2 * built->handles.size()) {
+                    built->dense.assign(span, 0);
+                    for (uint32_t group = 0; group < built->handles.size(); group++) {
+                        built->dense[built->handles[group] - built->handles.front()] = group + 1;
+                    }
+                }
+            }
+        } else {
+            // Unregistered entities are matched by key: sort (key, position) pairs, so ties
+            // keep schedule order without a stable sort
+            thread_local std::vector<std::pair<std::string_view, uint32_t>> keyed;
+            keyed.clear();
+            for (const auto& section : sections) {
+                keyed.emplace_back((entityAt(section).*keyOf)(), static_cast<uint32_t>(keyed.size()));
+            }
+            std::sort(keyed.begin(), keyed.end());
+            for (uint32_t i = 0; i < keyed.size(); i++) {
+                built->order[i] = &sections[keyed[i].second];
+                if (built->groups.empty() || built->groups.back().key != keyed[i].first) {
+                    built->groups.push_back({keyed[i].first, i, i});
+                }
+                built->groups.back().end = i + 1;
+            }
+        }
+        
+        // Another reader may have built it meanwhile; keep whichever was published first
+        if (slot.compare_exchange_strong(index, built.get(), std::memory_order_acq_rel)) {
+            index = built.release();
+        }
+    }
+    
+    const Ref<Section>* const* order = index->order.data();
+    auto spanOf = [&](const KeyIndex::Group& group) { return SectionSpan(order + group.begin, order + group.end); };
+    std::string_view key = (entity.*keyOf)();
+    
+    if (!index->handles.empty()) {
+        EntityHandle handle = entity.getHandle();
+        if (handle != NO_HANDLE) {
+            if (!index->dense.empty()) {
+                size_t slot = handle - size_t(index->handles.front());
+                uint32_t group = handle >= index->handles.front() && slot < index->dense.size() ? index->dense[slot] : 0;
+                return group ? spanOf(index->groups[group - 1]) : SectionSpan();
+            }
+            auto found = std::lower_bound(index->handles.begin(), index->handles.end(), handle);
+            if (found == index->handles.end() || *found != handle) {
+                return SectionSpan();
+            }
+            return spanOf(index->groups[found - index->handles.begin()]);
+        }
+        
+        // An unregistered entity can only match by key
+        auto found = std::lower_bound(index->byKey.begin(), index->byKey.end(), key,
+            [&](uint32_t group, std::string_view key) { return index->groups[group].key < key; });
+        if (found == index->byKey.end() || index->groups[*found].key != key) {
+            return SectionSpan();
+        }
+        return spanOf(index->groups[*found]);
+    }
+    
+    auto group = std::lower_bound(index->groups.begin(), index->groups.end(), key,
+        [](const KeyIndex::Group& group, std::string_view key) { return group.key < key; });
+    if (group == index->groups.end() || group->key != key) {
+        return SectionSpan();
     }
-    return result;
+    return spanOf(*group);
 }
 
 bool Schedule::hasConflicts() const {
-    for (size_t i = 0; i < sections.size(); ++i) {
-        for (size_t j = i + 1; j < sections.size(); ++j) {
-            // Check for time conflicts between any sections
-            if (sections[i]->getTimeSlot()->hasDay() && sections[i]->getTimeSlot()->hasStartTime() &&
-                sections[j]->getTimeSlot()->hasDay() && sections[j]->getTimeSlot()->hasStartTime()) {
-                // Any overlap in time is considered a conflict, regardless of teacher or course
-                if (sections[i]->getTimeSlot()->overlaps(*(sections[j]->getTimeSlot()))) {
-                    return true;
-                }
+    TRACE_SCOPE("Schedule::hasConflicts", "model");
+    for (auto first = sections.begin(); first != sections.end(); ++first) {
+        const TimeSlot& a = (*first)->getTimeSlot();
+        if (!a.hasDay() || !a.hasStartTime()) {
+            continue;
+        }
+        for (auto second = std::next(first); second != sections.end(); ++second) {
+            // Any overlap in time is considered a conflict, regardless of teacher or course
+            const TimeSlot& b = (*second)->getTimeSlot();
+            if (b.hasDay() && b.hasStartTime() && a.overlaps(b)) {
+                return true;
             }
         }
     }
     return false;
-} 
\ No newline at end of file
+} 
+
+// ScheduleDelta implementation
+ScheduleDelta::ScheduleDelta(std::shared_ptr<const Schedule> base)
+    : base(base) {}
+
+void ScheduleDelta::moveSection(size_t baseIndex, Ref<Section> replacement) {
+    flattened = nullptr;
+    
+    // Moving the same section twice just updates the existing override
+    for (auto& entry : overrides) {
+        if (entry.first == baseIndex) {
+            entry.second = replacement;
+            return;
+        }
+    }
+    overrides.emplace_back(baseIndex, replacement);
+}
+
+std::shared_ptr<const Schedule> ScheduleDelta::getBase() const {
+    return base;
+}
+
+size_t ScheduleDelta::size() const {
+    return base->getSections().size();
+}
+
+Ref<Section> ScheduleDelta::getSection(size_t index) const {
+    for (const auto& entry : overrides) {
+        if (entry.first == index) {
+            return entry.second;
+        }
+    }
+    return base->getSections()[index];
+}
+
+bool ScheduleDelta::hasConflicts() const {
+    TRACE_SCOPE("ScheduleDelta::hasConflicts", "model");
+    const auto& baseSections = base->getSections();
+    
+    for (const auto& entry : overrides) {
+        const TimeSlot& movedSlot = entry.second->getTimeSlot();
+        if (!movedSlot.hasDay() || !movedSlot.hasStartTime()) {
+            continue;
+        }
+        
+        // Compare the moved section against every other section as it appears in this delta
+        for (size_t i = 0; i < baseSections.size(); i++) {
+            if (i == entry.first) {
+                continue;
+            }
+            auto other = getSection(i);
+            if (movedSlot.overlaps(other->getTimeSlot())) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<Schedule> ScheduleDelta::flatten() const {
+    if (!flattened) {
+        // Shares everything with the base except the chunks holding moved sections
+        flattened = std::make_shared<Schedule>(*base);
+        for (const auto& entry : overrides) {
+            flattened->replaceSection(entry.first, entry.second);
+        }
+    }
+    return flattened;
+}
@@ -2,10 +2,17 @@
 #define MODELS_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <array>
+#include <iterator>
 #include <memory>
 #include <map>
 #include <set>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include "ObjectPool.hpp"
 
 // Forward declarations
 class Course;
@@ -14,99 +21,138 @@ class Section;
 class TimeSlot;
 class Requirement;
 class Schedule;
+class ScheduleDelta;
 
-// Class representing a time slot
+// Dense index a scheduler gives a course, teacher or section when it registers
+// it (see EntityRegistry). Handles only mean something within one scheduler.
+using EntityHandle = uint32_t;
+constexpr EntityHandle NO_HANDLE = 0xFFFFFFFF;
+
+// Class representing a time slot. A plain 8-byte value: sections and requirements
+// hold it inline and copying one never allocates.
 class TimeSlot {
 public:
     enum Day { MONDAY, TUESDAY, WEDNESDAY, THURSDAY, FRIDAY, UNASSIGNED };
     
-    // Constructor with optional day and start time (day is UNASSIGNED if not provided)
-    TimeSlot(int durationMinutes, Day day = UNASSIGNED, int startHour = -1, int startMinute = -1);
+    // Constructor with optional day and start time (day is UNASSIGNED if not provided).
+    // A negative hour or minute means no start time.
+    TimeSlot(int durationMinutes, Day day = UNASSIGNED, int startHour = -1, int startMinute = -1)
+        : durationMinutes(durationMinutes),
+          startMinutes(static_cast<int16_t>(startHour >= 0 && startMinute >= 0 ? startHour * 60 + startMinute : -1)),
+          day(static_cast<uint8_t>(day)),
+          reserved(0) {}
     
-    Day getDay() const;
-    int getStartHour() const;
-    int getStartMinute() const;
-    int getDurationMinutes() const;
+    Day getDay() const { return static_cast<Day>(day); }
+    int getStartHour() const { return startMinutes >= 0 ? startMinutes / 60 : -1; }
+    int getStartMinute() const { return startMinutes >= 0 ? startMinutes % 60 : -1; }
+    int getDurationMinutes() const { return durationMinutes; }
     std::string toString() const;
     
     bool overlaps(const TimeSlot& other) const;
-    bool hasStartTime() const;
-    bool hasDay() const;
+    bool hasStartTime() const { return startMinutes >= 0; }
+    bool hasDay() const { return day != UNASSIGNED; }
     
     // Create a complete timeslot with day and start time from a partial one
-    std::shared_ptr<TimeSlot> withStartTime(int startHour, int startMinute) const;
-    std::shared_ptr<TimeSlot> withDay(Day day) const;
-    std::shared_ptr<TimeSlot> withDayAndTime(Day day, int startHour, int startMinute) const;
+    TimeSlot withStartTime(int startHour, int startMinute) const;
+    TimeSlot withDay(Day day) const;
+    TimeSlot withDayAndTime(Day day, int startHour, int startMinute) const;
     
 private:
-    Day day;
-    int startHour;
-    int startMinute;
-    int durationMinutes;
+    int32_t durationMinutes;
+    int16_t startMinutes;  // Minutes after midnight, -1 for none
+    uint8_t day;
+    uint8_t reserved;
 };
 
+static_assert(sizeof(TimeSlot) == 8 && std::is_trivially_copyable<TimeSlot>::value,
+              "TimeSlot is copied by value throughout the solver");
+
 // Class representing a teacher
-class Teacher {
+class Teacher : public RefCounted {
 public:
     Teacher(const std::string& id, const std::string& name);
     
-    std::string getId() const;
-    std::string getName() const;
-    const std::vector<std::shared_ptr<Course>>& getCourses() const;
+    const std::string& getId() const;
+    const std::string& getName() const;
+    const std::vector<Ref<Course>>& getCourses() const;
+    
+    void addCourse(Ref<Course> course);
+    void removeCourse(Ref<Course> course);
     
-    void addCourse(std::shared_ptr<Course> course);
-    void removeCourse(std::shared_ptr<Course> course);
+    EntityHandle getHandle() const { return handle; }
+    void setHandle(EntityHandle handle) { this->handle = handle; }
+    
+    // Same handle when both are registered, same id otherwise
+    bool isSameAs(const Teacher& other) const;
     
 private:
     std::string id;
     std::string name;
-    std::vector<std::shared_ptr<Course>> courses;
+    EntityHandle handle = NO_HANDLE;
+    std::vector<Ref<Course>> courses;
 };
 
 // Class representing a course
-class Course {
+class Course : public RefCounted {
 public:
     Course(const std::string& code, const std::string& name, int credits);
     
-    std::string getCode() const;
-    std::string getName() const;
+    const std::string& getCode() const;
+    const std::string& getName() const;
     int getCredits() const;
     
-    const std::vector<std::shared_ptr<Section>>& getSections() const;
+    const std::vector<Ref<Section>>& getSections() const;
+    
+    void addSection(Ref<Section> section);
+    void removeSection(Ref<Section> section);
+    
+    EntityHandle getHandle() const { return handle; }
+    void setHandle(EntityHandle handle) { this->handle = handle; }
     
-    void addSection(std::shared_ptr<Section> section);
-    void removeSection(std::shared_ptr<Section> section);
+    // Same handle when both are registered, same code otherwise
+    bool isSameAs(const Course& other) const;
     
 private:
     std::string code;
     std::string name;
     int credits;
-    std::vector<std::shared_ptr<Section>> sections;
+    EntityHandle handle = NO_HANDLE;
+    std::vector<Ref<Section>> sections;
 };
 
 // Class representing a section of a course
-class Section {
+class Section : public RefCounted {
 public:
     // Constructor with optional pre-assigned time
-    Section(const std::string& id, std::shared_ptr<Course> course, 
-            std::shared_ptr<Teacher> teacher, std::shared_ptr<TimeSlot> timeSlot);
+    Section(const std::string& id, Ref<Course> course, 
+            Ref<Teacher> teacher, const TimeSlot& timeSlot);
     
-    std::string getId() const;
-    std::shared_ptr<Course> getCourse() const;
-    std::shared_ptr<Teacher> getTeacher() const;
-    std::shared_ptr<TimeSlot> getTimeSlot() const;
+    const std::string& getId() const;
+    const Ref<Course>& getCourse() const { return course; }
+    const Ref<Teacher>& getTeacher() const { return teacher; }
+    const TimeSlot& getTimeSlot() const { return timeSlot; }
     
-    void setTeacher(std::shared_ptr<Teacher> teacher);
-    void setTimeSlot(std::shared_ptr<TimeSlot> timeSlot);
+    void setTeacher(Ref<Teacher> teacher);
+    void setTimeSlot(const TimeSlot& timeSlot);
     
     // Create a new section with an assigned start time
-    std::shared_ptr<Section> withStartTime(int startHour, int startMinute) const;
+    Ref<Section> withStartTime(int startHour, int startMinute) const;
+    
+    // Create a placed copy of this section; it keeps the handle of the original
+    Ref<Section> withTimeSlot(const TimeSlot& timeSlot) const;
+    
+    EntityHandle getHandle() const { return handle; }
+    void setHandle(EntityHandle handle) { this->handle = handle; }
+    
+    // Same handle when both are registered (or copied from registered sections), same id otherwise
+    bool isSameAs(const Section& other) const;
     
 private:
     std::string id;
-    std::shared_ptr<Course> course;
-    std::shared_ptr<Teacher> teacher;
-    std::shared_ptr<TimeSlot> timeSlot;
+    Ref<Course> course;
+    Ref<Teacher> teacher;
+    TimeSlot timeSlot;
+    EntityHandle handle = NO_HANDLE;
 };
 
 // Base class for requirements
@@ -120,57 +166,229 @@ public:
 // Specific time slot requirement
 class TimeSlotRequirement : public Requirement {
 public:
-    TimeSlotRequirement(std::shared_ptr<Course> course, std::shared_ptr<TimeSlot> timeSlot);
+    TimeSlotRequirement(Ref<Course> course, const TimeSlot& timeSlot);
     bool isSatisfied(const Schedule& schedule) const override;
     std::string getDescription() const override;
     
+    const Ref<Course>& getCourse() const { return course; }
+    const TimeSlot& getTimeSlot() const { return timeSlot; }
+    
 private:
-    std::shared_ptr<Course> course;
-    std::shared_ptr<TimeSlot> timeSlot;
+    Ref<Course> course;
+    TimeSlot timeSlot;
 };
 
 // Teacher preference requirement
 class TeacherRequirement : public Requirement {
 public:
-    TeacherRequirement(std::shared_ptr<Course> course, std::shared_ptr<Teacher> teacher);
+    TeacherRequirement(Ref<Course> course, Ref<Teacher> teacher);
     bool isSatisfied(const Schedule& schedule) const override;
     std::string getDescription() const override;
     
+    const Ref<Course>& getCourse() const { return course; }
+    const Ref<Teacher>& getTeacher() const { return teacher; }
+    
 private:
-    std::shared_ptr<Course> course;
-    std::shared_ptr<Teacher> teacher;
+    Ref<Course> course;
+    Ref<Teacher> teacher;
 };
 
 // Section-specific time slot requirement
 class SectionTimeSlotRequirement : public Requirement {
 public:
-    SectionTimeSlotRequirement(std::shared_ptr<Section> section, std::shared_ptr<TimeSlot> timeSlot);
+    SectionTimeSlotRequirement(Ref<Section> section, const TimeSlot& timeSlot);
     bool isSatisfied(const Schedule& schedule) const override;
     std::string getDescription() const override;
     
-    std::shared_ptr<Section> getSection() const { return section; }
-    std::shared_ptr<TimeSlot> getTimeSlot() const { return timeSlot; }
+    const Ref<Section>& getSection() const { return section; }
+    const TimeSlot& getTimeSlot() const { return timeSlot; }
     
 private:
-    std::shared_ptr<Section> section;
-    std::shared_ptr<TimeSlot> timeSlot;
+    Ref<Section> section;
+    TimeSlot timeSlot;
 };
 
-// Class representing a complete schedule
+// Persistent sequence of sections: a spine of fixed-size chunks. Copies share the
+// spine and the chunks, and a copy only duplicates what it changes, so copying is
+// O(1) and replacing a section costs one spine and one chunk copy.
+class SectionList {
+    struct Chunk;
+    
+public:
+    static constexpr size_t CHUNK_SIZE = 16;
+    
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Ref<Section>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Ref<Section>*;
+        using reference = const Ref<Section>&;
+        
+        const_iterator() = default;
+        
+        reference operator*() const { return (*chunk)->sections[offset]; }
+        pointer operator->() const { return &**this; }
+        
+        const_iterator& operator++() {
+            if (++offset == CHUNK_SIZE) {
+                ++chunk;
+                offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        
+        bool operator==(const const_iterator& other) const { return chunk == other.chunk && offset == other.offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+        
+    private:
+        friend class SectionList;
+        const_iterator(const Ref<Chunk>* chunk, size_t offset) : chunk(chunk), offset(offset) {}
+        
+        const Ref<Chunk>* chunk = nullptr;
+        size_t offset = 0;
+    };
+    
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    
+    const Ref<Section>& operator[](size_t index) const {
+        return spine->chunks[index / CHUNK_SIZE]->sections[index % CHUNK_SIZE];
+    }
+    
+    const_iterator begin() const;
+    const_iterator end() const;
+    
+    void push_back(Ref<Section> section);
+    void set(size_t index, Ref<Section> section);
+    
+    // Flat copy for code that needs contiguous storage
+    std::vector<Ref<Section>> toVector() const;
+    
+private:
+    struct Chunk : RefCounted {
+        std::array<Ref<Section>, CHUNK_SIZE> sections;
+    };
+    struct Spine : RefCounted {
+        std::vector<Ref<Chunk>> chunks;
+    };
+    
+    Ref<Spine> spine;
+    size_t count = 0;
+    
+    // Unshared spine and chunk, copied first if another list still refers to them
+    Spine& writableSpine();
+    Chunk& writableChunk(size_t chunkIndex);
+};
+
+// The sections of one course or teacher within a schedule, in schedule order. A
+// view into the schedule's index, valid until the schedule changes or goes away.
+class SectionSpan {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Ref<Section>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Ref<Section>*;
+        using reference = const Ref<Section>&;
+        
+        explicit const_iterator(const Ref<Section>* const* at = nullptr) : at(at) {}
+        
+        reference operator*() const { return **at; }
+        pointer operator->() const { return *at; }
+        const_iterator& operator++() { ++at; return *this; }
+        const_iterator operator++(int) { return const_iterator(at++); }
+        
+        bool operator==(const const_iterator& other) const { return at == other.at; }
+        bool operator!=(const const_iterator& other) const { return at != other.at; }
+        
+    private:
+        const Ref<Section>* const* at;
+    };
+    
+    SectionSpan() = default;
+    SectionSpan(const Ref<Section>* const* first, const Ref<Section>* const* last) : first(first), last(last) {}
+    
+    const_iterator begin() const { return const_iterator(first); }
+    const_iterator end() const { return const_iterator(last); }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const Ref<Section>& operator[](size_t index) const { return *first[index]; }
+    
+private:
+    const Ref<Section>* const* first = nullptr;
+    const Ref<Section>* const* last = nullptr;
+};
+
+// Class representing a complete schedule. Copies share their sections (see SectionList).
 class Schedule {
 public:
     Schedule();
+    Schedule(const Schedule& other);
+    Schedule& operator=(const Schedule& other);
+    ~Schedule();
+    
+    void addSection(Ref<Section> section);
+    void removeSection(Ref<Section> section);
     
-    void addSection(std::shared_ptr<Section> section);
-    void removeSection(std::shared_ptr<Section> section);
+    // Puts another section in the given position; only this copy sees the change
+    void replaceSection(size_t index, Ref<Section> section);
     
-    const std::vector<std::shared_ptr<Section>>& getSections() const;
-    std::vector<std::shared_ptr<Section>> getSectionsForCourse(const std::string& courseCode) const;
+    const SectionList& getSections() const;
+    
+    // Sections of a course or taught by a teacher (matched as by isSameAs). The first
+    // call after a change indexes the whole schedule by that entity; later calls look
+    // up a range of the index and never allocate.
+    SectionSpan getSectionsForCourse(const Course& course) const;
+    SectionSpan getSectionsForTeacher(const Teacher& teacher) const;
     
     bool hasConflicts() const;
     
 private:
-    std::vector<std::shared_ptr<Section>> sections;
+    struct KeyIndex;
+    
+    SectionList sections;
+    
+    // Built lazily; schedules are read from more than one thread, so a built index is
+    // published atomically and only dropped by changes (which need exclusive access)
+    mutable std::atomic<KeyIndex*> courseIndex{nullptr};
+    mutable std::atomic<KeyIndex*> teacherIndex{nullptr};
+    
+    template <typename T>
+    SectionSpan lookup(std::atomic<KeyIndex*>& slot, const Ref<T>& (Section::*entityOf)() const,
+                       const std::string& (T::*keyOf)() const, const T& entity) const;
+    void dropIndexes();
+};
+
+// A schedule expressed as a shared, immutable base plus a small list of moved sections.
+// Creating one is O(1); the full Schedule is only built when flatten() is called.
+class ScheduleDelta {
+public:
+    explicit ScheduleDelta(std::shared_ptr<const Schedule> base);
+    
+    // Replace the section at the given position of the base schedule
+    void moveSection(size_t baseIndex, Ref<Section> replacement);
+    
+    std::shared_ptr<const Schedule> getBase() const;
+    size_t size() const;
+    Ref<Section> getSection(size_t index) const;
+    
+    // Only checks the moved sections, so the base is assumed to be conflict free
+    bool hasConflicts() const;
+    
+    // Materialize the full schedule (cached after the first call)
+    std::shared_ptr<Schedule> flatten() const;
+    
+private:
+    std::shared_ptr<const Schedule> base;
+    std::vector<std::pair<size_t, Ref<Section>>> overrides;
+    mutable std::shared_ptr<Schedule> flattened;
 };
 
 #endif // MODELS_HPP 
\ No newline at end of file
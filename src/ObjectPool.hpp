@@ -0,0 +1,226 @@
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Fixed-size slots for objects of one type. Each thread pops and pushes its own
+// free list without locking; slots are carved from chunks of CHUNK_SLOTS, and a
+// thread that exits hands its free list to the shared one so other threads can
+// take it. Chunks are kept for the life of the process.
+template <typename T>
+class ObjectPool {
+public:
+    static void* allocate() {
+        Cache& cache = local();
+        if (!cache.head) {
+            refill(cache);
+        }
+        Slot* slot = cache.head;
+        cache.head = slot->next;
+        return slot;
+    }
+
+    static void deallocate(void* memory) {
+        Cache& cache = local();
+        Slot* slot = static_cast<Slot*>(memory);
+        slot->next = cache.head;
+        cache.head = slot;
+    }
+
+private:
+    static constexpr size_t CHUNK_SLOTS = 256;
+
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Slot[]>> chunks;
+        Slot* head = nullptr;
+    };
+
+    struct Cache {
+        Slot* head = nullptr;
+
+        ~Cache() {
+            if (!head) {
+                return;
+            }
+            Slot* tail = head;
+            while (tail->next) {
+                tail = tail->next;
+            }
+            Shared& pool = shared();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            tail->next = pool.head;
+            pool.head = head;
+        }
+    };
+
+    // Never destroyed: objects may still be released while statics are torn down
+    static Shared& shared() {
+        static Shared* pool = new Shared();
+        return *pool;
+    }
+
+    static Cache& local() {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    static void refill(Cache& cache) {
+        Shared& pool = shared();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.head) {
+            cache.head = pool.head;
+            pool.head = nullptr;
+            return;
+        }
+        pool.chunks.emplace_back(new Slot[CHUNK_SLOTS]);
+        Slot* chunk = pool.chunks.back().get();
+        for (size_t i = 0; i + 1 < CHUNK_SLOTS; i++) {
+            chunk[i].next = &chunk[i + 1];
+        }
+        chunk[CHUNK_SLOTS - 1].next = nullptr;
+        cache.head = chunk;
+    }
+};
+
+template <typename T>
+class Ref;
+
+// Base for model objects held through Ref: the count lives in the object, so a
+// handle is one pointer and there is no separate control block. Copying an
+// object starts the copy with no references.
+class RefCounted {
+public:
+    // False for objects built in memory someone else owns (SolveArena)
+    bool isPooled() const { return pooled; }
+
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+    ~RefCounted() = default;
+
+private:
+    template <typename T>
+    friend class Ref;
+
+    mutable std::atomic<uint32_t> refs{0};
+    bool pooled = true;
+};
+
+// Intrusive shared handle with the parts of the shared_ptr interface the models
+// use. Counting is atomic because the UI hands schedules between threads.
+template <typename T>
+class Ref {
+public:
+    Ref() = default;
+    Ref(std::nullptr_t) {}
+    Ref(const Ref& other) : ptr(other.ptr) { retain(); }
+    Ref(Ref&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
+    ~Ref() { release(); }
+
+    Ref& operator=(const Ref& other) {
+        if (ptr != other.ptr) {
+            other.retain();
+            release();
+            ptr = other.ptr;
+        }
+        return *this;
+    }
+
+    Ref& operator=(Ref&& other) noexcept {
+        if (this != &other) {
+            release();
+            ptr = other.ptr;
+            other.ptr = nullptr;
+        }
+        return *this;
+    }
+
+    Ref& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    void reset() {
+        release();
+        ptr = nullptr;
+    }
+
+    T* get() const { return ptr; }
+    T& operator*() const { return *ptr; }
+    T* operator->() const { return ptr; }
+    explicit operator bool() const { return ptr != nullptr; }
+
+    // Exact only while no other thread can copy or drop a reference to the object
+    uint32_t use_count() const { return ptr ? ptr->refs.load(std::memory_order_acquire) : 0; }
+
+    friend bool operator==(const Ref& a, const Ref& b) { return a.ptr == b.ptr; }
+    friend bool operator!=(const Ref& a, const Ref& b) { return a.ptr != b.ptr; }
+    friend bool operator<(const Ref& a, const Ref& b) { return std::less<T*>()(a.ptr, b.ptr); }
+    friend bool operator==(const Ref& a, std::nullptr_t) { return a.ptr == nullptr; }
+    friend bool operator!=(const Ref& a, std::nullptr_t) { return a.ptr != nullptr; }
+
+    // Takes the first reference to an object just built in place; pooled
+    // objects go back to ObjectPool<T> when the last reference is dropped
+    static Ref adopt(T* object, bool pooled) {
+        object->pooled = pooled;
+        Ref ref;
+        ref.ptr = object;
+        ref.retain();
+        return ref;
+    }
+
+private:
+    T* ptr = nullptr;
+
+    void retain() const {
+        if (ptr) {
+            ptr->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release() {
+        if (ptr && ptr->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            bool pooled = ptr->pooled;
+            ptr->~T();
+            if (pooled) {
+                ObjectPool<T>::deallocate(ptr);
+            }
+        }
+    }
+};
+
+// Builds an object in a slot of its type's pool
+template <typename T, typename... Args>
+Ref<T> makeRef(Args&&... args) {
+    void* memory = ObjectPool<T>::allocate();
+    try {
+        return Ref<T>::adopt(new (memory) T(std::forward<Args>(args)...), true);
+    } catch (...) {
+        ObjectPool<T>::deallocate(memory);
+        throw;
+    }
+}
+
+// Builds an object in memory the caller owns; only the destructor runs when the
+// last reference is dropped
+template <typename T, typename... Args>
+Ref<T> makeRefAt(void* memory, Args&&... args) {
+    return Ref<T>::adopt(new (memory) T(std::forward<Args>(args)...), false);
+}
+
+#endif // OBJECT_POOL_HPP
@@ -1,4 +1,5 @@
 #include "PQTree.hpp"
+#include "Trace.hpp"
 #include <algorithm>
 #include <queue>
 #include <map>
@@ -23,11 +24,11 @@ void PQNode::setLabel(const std::string& label) {
     this->label = label;
 }
 
-void PQNode::addChild(std::shared_ptr<PQNode> child) {
+void PQNode::addChild(Ref<PQNode> child) {
     children.push_back(child);
 }
 
-const std::vector<std::shared_ptr<PQNode>>& PQNode::getChildren() const {
+const std::vector<Ref<PQNode>>& PQNode::getChildren() const {
     return children;
 }
 
@@ -47,60 +48,61 @@ void PQNode::setPosition(int x, int y) {
 // PQTree implementation
 PQTree::PQTree() : root(nullptr) {}
 
-void PQTree::setRoot(std::shared_ptr<PQNode> node) {
+void PQTree::setRoot(Ref<PQNode> node) {
     root = node;
 }
 
-std::shared_ptr<PQNode> PQTree::getRoot() const {
+Ref<PQNode> PQTree::getRoot() const {
     return root;
 }
 
-std::shared_ptr<PQNode> PQTree::createLeaf(const std::string& label) {
-    return std::make_shared<PQNode>(NodeType::LEAF, label);
+Ref<PQNode> PQTree::createLeaf(const std::string& label) {
+    return makeRef<PQNode>(NodeType::LEAF, label);
 }
 
-std::shared_ptr<PQNode> PQTree::createPNode(const std::string& label) {
-    return std::make_shared<PQNode>(NodeType::P_NODE, label);
+Ref<PQNode> PQTree::createPNode(const std::string& label) {
+    return makeRef<PQNode>(NodeType::P_NODE, label);
 }
 
-std::shared_ptr<PQNode> PQTree::createQNode(const std::string& label) {
-    return std::make_shared<PQNode>(NodeType::Q_NODE, label);
+Ref<PQNode> PQTree::createQNode(const std::string& label) {
+    return makeRef<PQNode>(NodeType::Q_NODE, label);
 }
 
 // Build a time-ordered tree from a set of sections
-void PQTree::buildTimeOrderedTree(const std::vector<std::shared_ptr<Section>>& sections) {
+void PQTree::buildTimeOrderedTree(const std::vector<Ref<Section>>& sections) {
+    TRACE_SCOPE("PQTree::buildTimeOrderedTree", "pqtree");
     // Sort sections by their time slot
-    std::vector<std::shared_ptr<Section>> sortedSections = sections;
+    std::vector<Ref<Section>> sortedSections = sections;
     std::sort(sortedSections.begin(), sortedSections.end(),
-        [](const std::shared_ptr<Section>& a, const std::shared_ptr<Section>& b) {
+        [](const Ref<Section>& a, const Ref<Section>& b) {
             auto slotA = a->getTimeSlot();
             auto slotB = b->getTimeSlot();
             
             // First, sort by day if both have assigned days
-            if (slotA->hasDay() && slotB->hasDay()) {
-                if (slotA->getDay() != slotB->getDay()) {
-                    return slotA->getDay() < slotB->getDay();
+            if (slotA.hasDay() && slotB.hasDay()) {
+                if (slotA.getDay() != slotB.getDay()) {
+                    return slotA.getDay() < slotB.getDay();
                 }
-            } else if (slotA->hasDay()) {
+            } else if (slotA.hasDay()) {
                 return true; // Sections with assigned days come first
-            } else if (slotB->hasDay()) {
+            } else if (slotB.hasDay()) {
                 return false;
             }
             
             // If both have start times, sort by start time
-            if (slotA->hasStartTime() && slotB->hasStartTime()) {
-                if (slotA->getStartHour() != slotB->getStartHour()) {
-                    return slotA->getStartHour() < slotB->getStartHour();
+            if (slotA.hasStartTime() && slotB.hasStartTime()) {
+                if (slotA.getStartHour() != slotB.getStartHour()) {
+                    return slotA.getStartHour() < slotB.getStartHour();
                 }
-                return slotA->getStartMinute() < slotB->getStartMinute();
-            } else if (slotA->hasStartTime()) {
+                return slotA.getStartMinute() < slotB.getStartMinute();
+            } else if (slotA.hasStartTime()) {
                 return true; // Sections with assigned start times come first
-            } else if (slotB->hasStartTime()) {
+            } else if (slotB.hasStartTime()) {
                 return false;
             }
             
             // If neither has day or start time, sort by duration (longer duration first)
-            return slotA->getDurationMinutes() > slotB->getDurationMinutes();
+            return slotA.getDurationMinutes() > slotB.getDurationMinutes();
         });
     
     // Create a Q-node as root
@@ -108,7 +110,7 @@ void PQTree::buildTimeOrderedTree(const std::vector<std::shared_ptr<Section>>& s
     for (const auto& section : sortedSections) {
         std::string label = section->getCourse()->getCode() + " (" + 
                            section->getTeacher()->getName() + ", " +
-                           section->getTimeSlot()->toString() + ")";
+                           section->getTimeSlot().toString() + ")";
         auto leaf = createLeaf(label);
         qNode->addChild(leaf);
     }
@@ -125,7 +127,7 @@ std::string PQTree::print() const {
 }
 
 // Helper to print the tree
-void PQTree::printTree(std::shared_ptr<PQNode> node, int depth, std::stringstream& ss) const {
+void PQTree::printTree(Ref<PQNode> node, int depth, std::stringstream& ss) const {
     std::string indent(depth * 2, ' ');
     if (node->getType() == NodeType::LEAF) {
         ss << indent << "Leaf: " << node->getLabel() << "\n";
@@ -140,6 +142,7 @@ void PQTree::printTree(std::shared_ptr<PQNode> node, int depth, std::stringstrea
 
 // Generate all valid frontier permutations
 std::vector<std::vector<std::string>> PQTree::getFrontiers() const {
+    TRACE_SCOPE("PQTree::getFrontiers", "pqtree");
     std::vector<std::vector<std::string>> permutations;
     if (root) {
         generatePermutations(root, permutations, {});
@@ -151,7 +154,7 @@ std::vector<std::vector<std::string>> PQTree::getFrontiers() const {
 }
 
 // Helper to generate permutations for a node
-void PQTree::generatePermutations(std::shared_ptr<PQNode> node, 
+void PQTree::generatePermutations(Ref<PQNode> node, 
                                  std::vector<std::vector<std::string>>& permutations, 
                                  std::vector<std::string> current) const {
     if (node->getType() == NodeType::LEAF) {
@@ -226,20 +229,20 @@ void PQTree::reorder() {
     if (!root) return;
     
     // Function to reorder a subtree
-    std::function<void(std::shared_ptr<PQNode>)> reorderNode;
-    reorderNode = [&](std::shared_ptr<PQNode> node) {
+    std::function<void(Ref<PQNode>)> reorderNode;
+    reorderNode = [&](Ref<PQNode> node) {
         if (!node) return;
         
         if (node->getType() == NodeType::P_NODE) {
             // For P-nodes, we can reorder children in any way
-            auto& children = const_cast<std::vector<std::shared_ptr<PQNode>>&>(node->getChildren());
+            auto& children = const_cast<std::vector<Ref<PQNode>>&>(node->getChildren());
             // Use modern C++ shuffle instead of deprecated random_shuffle
             std::random_device rd;
             std::mt19937 g(rd());
             std::shuffle(children.begin(), children.end(), g);
         } else if (node->getType() == NodeType::Q_NODE) {
             // For Q-nodes, we can only reverse the order
-            auto& children = const_cast<std::vector<std::shared_ptr<PQNode>>&>(node->getChildren());
+            auto& children = const_cast<std::vector<Ref<PQNode>>&>(node->getChildren());
             if (rand() % 2 == 0) {
                 std::reverse(children.begin(), children.end());
             }
@@ -263,8 +266,8 @@ void PQTree::computeLayout() {
     const int NODE_WIDTH = 60;
     
     // First, perform a breadth-first traversal to determine levels
-    std::map<std::shared_ptr<PQNode>, int> nodeLevels;
-    std::queue<std::shared_ptr<PQNode>> queue;
+    std::map<Ref<PQNode>, int> nodeLevels;
+    std::queue<Ref<PQNode>> queue;
     
     queue.push(root);
     nodeLevels[root] = 0;
@@ -282,7 +285,7 @@ void PQTree::computeLayout() {
     }
     
     // Next, position nodes based on their level
-    std::map<int, std::vector<std::shared_ptr<PQNode>>> levelNodes;
+    std::map<int, std::vector<Ref<PQNode>>> levelNodes;
     for (const auto& pair : nodeLevels) {
         levelNodes[pair.second].push_back(pair.first);
     }
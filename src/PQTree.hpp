@@ -13,7 +13,7 @@ enum class NodeType {
     LEAF     // Terminal node representing actual items
 };
 
-class PQNode {
+class PQNode : public RefCounted {
 public:
     PQNode(NodeType type, const std::string& label = "");
     virtual ~PQNode() = default;
@@ -22,8 +22,8 @@ public:
     std::string getLabel() const;
     void setLabel(const std::string& label);
     
-    void addChild(std::shared_ptr<PQNode> child);
-    const std::vector<std::shared_ptr<PQNode>>& getChildren() const;
+    void addChild(Ref<PQNode> child);
+    const std::vector<Ref<PQNode>>& getChildren() const;
     
     // For visualization purposes
     int getX() const;
@@ -33,7 +33,7 @@ public:
 private:
     NodeType type;
     std::string label;
-    std::vector<std::shared_ptr<PQNode>> children;
+    std::vector<Ref<PQNode>> children;
     
     // For visualization
     int x, y;
@@ -44,18 +44,18 @@ public:
     PQTree();
     ~PQTree() = default;
     
-    void setRoot(std::shared_ptr<PQNode> node);
-    std::shared_ptr<PQNode> getRoot() const;
+    void setRoot(Ref<PQNode> node);
+    Ref<PQNode> getRoot() const;
     
     // Create a leaf node
-    std::shared_ptr<PQNode> createLeaf(const std::string& label);
+    Ref<PQNode> createLeaf(const std::string& label);
     
     // Create P or Q nodes
-    std::shared_ptr<PQNode> createPNode(const std::string& label = "");
-    std::shared_ptr<PQNode> createQNode(const std::string& label = "");
+    Ref<PQNode> createPNode(const std::string& label = "");
+    Ref<PQNode> createQNode(const std::string& label = "");
     
     // Build a time-ordered tree from sections
-    void buildTimeOrderedTree(const std::vector<std::shared_ptr<Section>>& sections);
+    void buildTimeOrderedTree(const std::vector<Ref<Section>>& sections);
     
     // Print the tree structure
     std::string print() const;
@@ -74,11 +74,11 @@ public:
     void computeLayout();
     
 private:
-    std::shared_ptr<PQNode> root;
+    Ref<PQNode> root;
     
     // Helper methods
-    void printTree(std::shared_ptr<PQNode> node, int depth, std::stringstream& ss) const;
-    void generatePermutations(std::shared_ptr<PQNode> node, 
+    void printTree(Ref<PQNode> node, int depth, std::stringstream& ss) const;
+    void generatePermutations(Ref<PQNode> node, 
                              std::vector<std::vector<std::string>>& permutations, 
                              std::vector<std::string> current) const;
 };
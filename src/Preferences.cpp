@@ -0,0 +1,272 @@
+#include "Preferences.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+    const char* dayName(TimeSlot::Day day) {
+        const char* names[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "any day"};
+        return names[static_cast<int>(day)];
+    }
+    
+    int startMinutesOf(const TimeSlot& timeSlot) {
+        return timeSlot.getStartHour() * 60 + timeSlot.getStartMinute();
+    }
+    
+    bool isPlaced(const TimeSlot& timeSlot) {
+        return timeSlot.hasDay() && timeSlot.hasStartTime();
+    }
+}
+
+// StudentPreference factories
+StudentPreference StudentPreference::preferTeacher(const std::string& courseCode, const std::string& teacherId, double weight) {
+    return StudentPreference{PREFER_TEACHER, weight, courseCode, teacherId, TimeSlot::UNASSIGNED, -1, -1};
+}
+
+StudentPreference StudentPreference::avoidTeacher(const std::string& courseCode, const std::string& teacherId, double weight) {
+    return StudentPreference{AVOID_TEACHER, weight, courseCode, teacherId, TimeSlot::UNASSIGNED, -1, -1};
+}
+
+StudentPreference StudentPreference::preferTimeSlot(const std::string& courseCode, TimeSlot::Day day, int startHour, int endHour, double weight) {
+    return StudentPreference{PREFER_TIME_SLOT, weight, courseCode, "", day, startHour, endHour};
+}
+
+StudentPreference StudentPreference::avoidTimeSlot(const std::string& courseCode, TimeSlot::Day day, int startHour, int endHour, double weight) {
+    return StudentPreference{AVOID_TIME_SLOT, weight, courseCode, "", day, startHour, endHour};
+}
+
+StudentPreference StudentPreference::noEarlyClasses(int earliestHour, double weight) {
+    return StudentPreference{NO_EARLY_CLASSES, weight, "", "", TimeSlot::UNASSIGNED, earliestHour, -1};
+}
+
+StudentPreference StudentPreference::compactDays(double weight) {
+    return StudentPreference{COMPACT_DAYS, weight, "", "", TimeSlot::UNASSIGNED, -1, -1};
+}
+
+std::string StudentPreference::getDescription() const {
+    std::stringstream ss;
+    std::string target = courseCode.empty() ? "any course" : courseCode;
+    
+    switch (type) {
+        case PREFER_TEACHER:
+            ss << "Prefer teacher " << teacherId << " for " << target;
+            break;
+        case AVOID_TEACHER:
+            ss << "Avoid teacher " << teacherId << " for " << target;
+            break;
+        case PREFER_TIME_SLOT:
+            ss << "Prefer " << target << " on " << dayName(day) << " " << startHour << ":00-" << endHour << ":00";
+            break;
+        case AVOID_TIME_SLOT:
+            ss << "Avoid " << target << " on " << dayName(day) << " " << startHour << ":00-" << endHour << ":00";
+            break;
+        case NO_EARLY_CLASSES:
+            ss << "No classes before " << startHour << ":00";
+            break;
+        case COMPACT_DAYS:
+            ss << "Keep days compact";
+            break;
+    }
+    ss << " (weight " << weight << ")";
+    return ss.str();
+}
+
+// PreferenceScorer implementation
+PreferenceScorer::PreferenceScorer() : compactWeight(0.0) {}
+
+PreferenceScorer::PreferenceScorer(const std::vector<StudentPreference>& preferences)
+    : preferences(preferences), compactWeight(0.0) {
+    
+    // Index section level preferences by course; COMPACT_DAYS is a per-day term
+    for (size_t i = 0; i < this->preferences.size(); i++) {
+        const auto& preference = this->preferences[i];
+        if (preference.type == StudentPreference::COMPACT_DAYS) {
+            compactWeight += preference.weight;
+        } else if (preference.courseCode.empty()) {
+            globalPreferences.push_back(i);
+        } else {
+            preferencesByCourse[preference.courseCode].push_back(i);
+        }
+    }
+}
+
+double PreferenceScorer::scoreOne(const StudentPreference& preference, const Section& section, const TimeSlot& timeSlot) const {
+    switch (preference.type) {
+        case StudentPreference::PREFER_TEACHER:
+            return section.getTeacher()->getId() == preference.teacherId ? preference.weight : 0.0;
+            
+        case StudentPreference::AVOID_TEACHER:
+            return section.getTeacher()->getId() == preference.teacherId ? -preference.weight : 0.0;
+            
+        case StudentPreference::PREFER_TIME_SLOT:
+        case StudentPreference::AVOID_TIME_SLOT: {
+            if (!isPlaced(timeSlot)) return 0.0;
+            if (preference.day != TimeSlot::UNASSIGNED && preference.day != timeSlot.getDay()) return 0.0;
+            
+            int start = startMinutesOf(timeSlot);
+            bool inside = start >= preference.startHour * 60 && start < preference.endHour * 60;
+            if (!inside) return 0.0;
+            return preference.type == StudentPreference::PREFER_TIME_SLOT ? preference.weight : -preference.weight;
+        }
+        
+        case StudentPreference::NO_EARLY_CLASSES:
+            if (!isPlaced(timeSlot)) return 0.0;
+            return startMinutesOf(timeSlot) < preference.startHour * 60 ? -preference.weight : 0.0;
+            
+        case StudentPreference::COMPACT_DAYS:
+            return 0.0;
+    }
+    return 0.0;
+}
+
+double PreferenceScorer::scoreSection(const Section& section, const TimeSlot& timeSlot) const {
+    double score = 0.0;
+    
+    for (size_t index : globalPreferences) {
+        score += scoreOne(preferences[index], section, timeSlot);
+    }
+    
+    auto it = preferencesByCourse.find(section.getCourse()->getCode());
+    if (it != preferencesByCourse.end()) {
+        for (size_t index : it->second) {
+            score += scoreOne(preferences[index], section, timeSlot);
+        }
+    }
+    return score;
+}
+
+double PreferenceScorer::scoreDay(int firstStart, int lastEnd, int busyMinutes) const {
+    if (compactWeight == 0.0) return 0.0;
+    
+    // Overlapping classes can make busy time exceed the span, which is not idle time
+    int idleMinutes = std::max(0, (lastEnd - firstStart) - busyMinutes);
+    return -compactWeight * idleMinutes / 60.0;
+}
+
+double PreferenceScorer::evaluate(const Schedule& schedule) const {
+    if (preferences.empty()) return 0.0;
+    
+    double score = 0.0;
+    int firstStart[5], lastEnd[5], busyMinutes[5];
+    bool used[5] = {false, false, false, false, false};
+    
+    for (const auto& section : schedule.getSections()) {
+        const TimeSlot& timeSlot = section->getTimeSlot();
+        score += scoreSection(*section, timeSlot);
+        
+        if (!isPlaced(timeSlot)) continue;
+        
+        int day = static_cast<int>(timeSlot.getDay());
+        int start = startMinutesOf(timeSlot);
+        int end = start + timeSlot.getDurationMinutes();
+        if (!used[day]) {
+            used[day] = true;
+            firstStart[day] = start;
+            lastEnd[day] = end;
+            busyMinutes[day] = 0;
+        }
+        firstStart[day] = std::min(firstStart[day], start);
+        lastEnd[day] = std::max(lastEnd[day], end);
+        busyMinutes[day] += timeSlot.getDurationMinutes();
+    }
+    
+    for (int day = 0; day < 5; day++) {
+        if (used[day]) {
+            score += scoreDay(firstStart[day], lastEnd[day], busyMinutes[day]);
+        }
+    }
+    return score;
+}
+
+bool PreferenceScorer::empty() const {
+    return preferences.empty();
+}
+
+bool PreferenceScorer::hasCompactDays() const {
+    return compactWeight != 0.0;
+}
+
+// IncrementalPreferenceScore implementation
+IncrementalPreferenceScore::IncrementalPreferenceScore(const PreferenceScorer& scorer,
+                                                       const std::vector<Ref<Section>>& sections)
+    : scorer(scorer), sections(sections), total(0.0) {
+    placements.reserve(sections.size());
+    sectionScores.reserve(sections.size());
+    
+    for (const auto& section : sections) {
+        const TimeSlot& timeSlot = section->getTimeSlot();
+        placements.push_back(timeSlot);
+        sectionScores.push_back(scorer.scoreSection(*section, timeSlot));
+        total += sectionScores.back();
+        if (scorer.hasCompactDays()) {
+            addToDay(timeSlot);
+        }
+    }
+    
+    for (int day = 0; day < 5; day++) {
+        dayScores[day] = 0.0;
+        total += rescoreDay(day);
+    }
+}
+
+double IncrementalPreferenceScore::getScore() const {
+    return total;
+}
+
+void IncrementalPreferenceScore::addToDay(const TimeSlot& timeSlot) {
+    if (!isPlaced(timeSlot)) return;
+    
+    DayState& state = days[static_cast<int>(timeSlot.getDay())];
+    int start = startMinutesOf(timeSlot);
+    state.starts.insert(start);
+    state.ends.insert(start + timeSlot.getDurationMinutes());
+    state.busyMinutes += timeSlot.getDurationMinutes();
+}
+
+void IncrementalPreferenceScore::removeFromDay(const TimeSlot& timeSlot) {
+    if (!isPlaced(timeSlot)) return;
+    
+    DayState& state = days[static_cast<int>(timeSlot.getDay())];
+    int start = startMinutesOf(timeSlot);
+    state.starts.erase(state.starts.find(start));
+    state.ends.erase(state.ends.find(start + timeSlot.getDurationMinutes()));
+    state.busyMinutes -= timeSlot.getDurationMinutes();
+}
+
+// Recompute one day's compactness term and return how much it changed
+double IncrementalPreferenceScore::rescoreDay(int day) {
+    const DayState& state = days[day];
+    double score = 0.0;
+    if (!state.starts.empty()) {
+        score = scorer.scoreDay(*state.starts.begin(), *state.ends.rbegin(), state.busyMinutes);
+    }
+    double change = score - dayScores[day];
+    dayScores[day] = score;
+    return change;
+}
+
+double IncrementalPreferenceScore::applyMove(size_t sectionIndex, TimeSlot::Day day, int startMinutes) {
+    double before = total;
+    
+    TimeSlot oldSlot = placements[sectionIndex];
+    TimeSlot newSlot(oldSlot.getDurationMinutes(), day, startMinutes / 60, startMinutes % 60);
+    
+    // Rescore the moved section
+    double newSectionScore = scorer.scoreSection(*sections[sectionIndex], newSlot);
+    total += newSectionScore - sectionScores[sectionIndex];
+    sectionScores[sectionIndex] = newSectionScore;
+    placements[sectionIndex] = newSlot;
+    
+    // Only the old and new day can change their compactness term
+    if (scorer.hasCompactDays()) {
+        removeFromDay(oldSlot);
+        addToDay(newSlot);
+        if (isPlaced(oldSlot)) {
+            total += rescoreDay(static_cast<int>(oldSlot.getDay()));
+        }
+        if (isPlaced(newSlot) && (!isPlaced(oldSlot) || newSlot.getDay() != oldSlot.getDay())) {
+            total += rescoreDay(static_cast<int>(newSlot.getDay()));
+        }
+    }
+    
+    return total - before;
+}
@@ -0,0 +1,100 @@
+#ifndef PREFERENCES_HPP
+#define PREFERENCES_HPP
+
+#include "Models.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+// A weighted soft constraint. Unlike a Requirement it never rejects a schedule,
+// it only makes it score better or worse.
+struct StudentPreference {
+    enum Type {
+        PREFER_TEACHER,    // +weight for each section of the course taught by teacherId
+        AVOID_TEACHER,     // -weight for each section of the course taught by teacherId
+        PREFER_TIME_SLOT,  // +weight for each section starting inside the window
+        AVOID_TIME_SLOT,   // -weight for each section starting inside the window
+        NO_EARLY_CLASSES,  // -weight for each section starting before startHour
+        COMPACT_DAYS       // -weight for every idle hour between classes on a day
+    };
+    
+    Type type;
+    double weight;
+    std::string courseCode;      // Empty applies to every course
+    std::string teacherId;       // Teacher preferences only
+    TimeSlot::Day day;           // Time slot preferences (UNASSIGNED matches any day)
+    int startHour;               // Window start, or earliest hour for NO_EARLY_CLASSES
+    int endHour;                 // Window end (exclusive)
+    
+    static StudentPreference preferTeacher(const std::string& courseCode, const std::string& teacherId, double weight);
+    static StudentPreference avoidTeacher(const std::string& courseCode, const std::string& teacherId, double weight);
+    static StudentPreference preferTimeSlot(const std::string& courseCode, TimeSlot::Day day, int startHour, int endHour, double weight);
+    static StudentPreference avoidTimeSlot(const std::string& courseCode, TimeSlot::Day day, int startHour, int endHour, double weight);
+    static StudentPreference noEarlyClasses(int earliestHour, double weight);
+    static StudentPreference compactDays(double weight);
+    
+    std::string getDescription() const;
+};
+
+// Evaluates a set of preferences. Section level preferences are indexed by
+// course so scoring a section only looks at the preferences that can apply to it.
+class PreferenceScorer {
+public:
+    PreferenceScorer();
+    explicit PreferenceScorer(const std::vector<StudentPreference>& preferences);
+    
+    // Contribution of one section placed in the given time slot (excludes COMPACT_DAYS)
+    double scoreSection(const Section& section, const TimeSlot& timeSlot) const;
+    
+    // Penalty for idle time on one day given its span and total class minutes
+    double scoreDay(int firstStart, int lastEnd, int busyMinutes) const;
+    
+    // Full evaluation of a schedule
+    double evaluate(const Schedule& schedule) const;
+    
+    bool empty() const;
+    bool hasCompactDays() const;
+    
+private:
+    std::vector<StudentPreference> preferences;
+    std::unordered_map<std::string, std::vector<size_t>> preferencesByCourse;
+    std::vector<size_t> globalPreferences;
+    double compactWeight;
+    
+    double scoreOne(const StudentPreference& preference, const Section& section, const TimeSlot& timeSlot) const;
+};
+
+// Keeps the preference score of a schedule up to date as single sections move.
+// A move only rescores the moved section and the (at most two) days it touches.
+// The scorer must outlive this object.
+class IncrementalPreferenceScore {
+public:
+    IncrementalPreferenceScore(const PreferenceScorer& scorer, const std::vector<Ref<Section>>& sections);
+    
+    double getScore() const;
+    
+    // Move a section to a new day and start (minutes since midnight), returns the score change
+    double applyMove(size_t sectionIndex, TimeSlot::Day day, int startMinutes);
+    
+private:
+    struct DayState {
+        std::multiset<int> starts;
+        std::multiset<int> ends;
+        int busyMinutes = 0;
+    };
+    
+    const PreferenceScorer& scorer;
+    std::vector<Ref<Section>> sections;
+    std::vector<TimeSlot> placements;
+    std::vector<double> sectionScores;
+    DayState days[5];
+    double dayScores[5];
+    double total;
+    
+    void addToDay(const TimeSlot& timeSlot);
+    void removeFromDay(const TimeSlot& timeSlot);
+    double rescoreDay(int day);
+};
+
+#endif // PREFERENCES_HPP 
@@ -0,0 +1,142 @@
+#include "SatEncoder.hpp"
+#include <algorithm>
+
+TimetableSatEncoder::TimetableSatEncoder(const std::vector<Ref<Section>>& sections,
+                                         const std::vector<std::shared_ptr<Requirement>>& requirements,
+                                         const SatScheduleOptions& options)
+    : sections(sections), requirements(requirements), options(options) {
+    encode();
+}
+
+const SatSolver& TimetableSatEncoder::getSolver() const {
+    return solver;
+}
+
+// Does a (day, start) placement agree with the parts of a required slot that are set?
+bool TimetableSatEncoder::matches(const TimeSlot& required, TimeSlot::Day day, int start) const {
+    if (required.hasDay() && required.getDay() != day) {
+        return false;
+    }
+    if (required.hasStartTime() && required.getStartHour() * 60 + required.getStartMinute() != start) {
+        return false;
+    }
+    return true;
+}
+
+void TimetableSatEncoder::encode() {
+    int step = std::max(1, options.startStepMinutes);
+    int cellsPerDay = (24 * 60 + step - 1) / step;
+    
+    // Sections pinned by a requirement only get placements that match it
+    std::vector<const TimeSlot*> pinned(sections.size(), nullptr);
+    for (const auto& req : requirements) {
+        auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(req);
+        if (!sectionReq) continue;
+        for (size_t i = 0; i < sections.size(); i++) {
+            if (sections[i]->isSameAs(*sectionReq->getSection())) {
+                pinned[i] = &sectionReq->getTimeSlot();
+            }
+        }
+    }
+    
+    // One variable per section x day x start
+    candidates.assign(sections.size(), std::vector<Candidate>());
+    for (size_t i = 0; i < sections.size(); i++) {
+        int duration = sections[i]->getTimeSlot().getDurationMinutes();
+        
+        for (int dayIndex = 0; dayIndex < 5; dayIndex++) {
+            TimeSlot::Day day = static_cast<TimeSlot::Day>(dayIndex);
+            
+            // A pinned start outside the normal window is still allowed
+            std::vector<int> starts;
+            if (pinned[i] && pinned[i]->hasStartTime()) {
+                starts.push_back(pinned[i]->getStartHour() * 60 + pinned[i]->getStartMinute());
+            } else {
+                for (int start = options.earliestStartMinutes; start + duration <= options.latestEndMinutes; start += step) {
+                    starts.push_back(start);
+                }
+            }
+            
+            for (int start : starts) {
+                if (pinned[i] && !matches(*pinned[i], day, start)) continue;
+                candidates[i].push_back(Candidate{day, start, solver.newVar()});
+            }
+        }
+    }
+    
+    // Every section takes exactly one placement
+    for (const auto& sectionCandidates : candidates) {
+        std::vector<int> lits;
+        for (const auto& candidate : sectionCandidates) {
+            lits.push_back(SatSolver::makeLit(candidate.var));
+        }
+        solver.addExactlyOne(lits);
+    }
+    
+    // Occupancy: placement -> cell, and at most one section per cell
+    std::vector<std::vector<int>> cellOccupants(5 * cellsPerDay);
+    for (size_t i = 0; i < sections.size(); i++) {
+        int duration = sections[i]->getTimeSlot().getDurationMinutes();
+        std::vector<int> occupancyVar(5 * cellsPerDay, -1);
+        
+        for (const auto& candidate : candidates[i]) {
+            int firstCell = std::max(0, candidate.start / step);
+            int lastCell = std::min(cellsPerDay, (candidate.start + duration + step - 1) / step);
+            
+            for (int cell = firstCell; cell < lastCell; cell++) {
+                int key = static_cast<int>(candidate.day) * cellsPerDay + cell;
+                if (occupancyVar[key] < 0) {
+                    occupancyVar[key] = solver.newVar();
+                    cellOccupants[key].push_back(SatSolver::makeLit(occupancyVar[key]));
+                }
+                solver.addClause({SatSolver::makeLit(candidate.var, true), SatSolver::makeLit(occupancyVar[key])});
+            }
+        }
+    }
+    for (const auto& occupants : cellOccupants) {
+        solver.addAtMostOne(occupants);
+    }
+    
+    // A course time slot requirement needs at least one matching section placement
+    for (const auto& req : requirements) {
+        auto courseReq = std::dynamic_pointer_cast<TimeSlotRequirement>(req);
+        if (!courseReq) continue;
+        
+        std::vector<int> lits;
+        for (size_t i = 0; i < sections.size(); i++) {
+            if (!sections[i]->getCourse()->isSameAs(*courseReq->getCourse())) continue;
+            for (const auto& candidate : candidates[i]) {
+                if (matches(courseReq->getTimeSlot(), candidate.day, candidate.start)) {
+                    lits.push_back(SatSolver::makeLit(candidate.var));
+                }
+            }
+        }
+        solver.addClause(lits);
+    }
+    
+    // Teacher requirements do not depend on placement, so they are left to the final check
+}
+
+SatSolver::Result TimetableSatEncoder::solve() {
+    SatLimits limits;
+    limits.timeBudgetMs = options.timeBudgetMs;
+    limits.maxConflicts = options.maxConflicts;
+    limits.cancel = options.cancel;
+    return solver.solve(limits);
+}
+
+std::shared_ptr<Schedule> TimetableSatEncoder::decode() const {
+    auto schedule = std::make_shared<Schedule>();
+    
+    for (size_t i = 0; i < sections.size(); i++) {
+        for (const auto& candidate : candidates[i]) {
+            if (!solver.modelValue(candidate.var)) continue;
+            
+            TimeSlot timeSlot(sections[i]->getTimeSlot().getDurationMinutes(),
+                              candidate.day, candidate.start / 60, candidate.start % 60);
+            schedule->addSection(sections[i]->withTimeSlot(timeSlot));
+            break;
+        }
+    }
+    return schedule;
+}
@@ -0,0 +1,54 @@
+#ifndef SAT_ENCODER_HPP
+#define SAT_ENCODER_HPP
+
+#include "Models.hpp"
+#include "SatSolver.hpp"
+#include <vector>
+#include <memory>
+
+struct SatScheduleOptions {
+    int earliestStartMinutes = 8 * 60;  // Candidate starts lie inside this window
+    int latestEndMinutes = 20 * 60;
+    int startStepMinutes = 15;          // Also the size of the occupancy cells
+    int timeBudgetMs = 10000;
+    long maxConflicts = -1;
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+// Encodes the timetable as CNF: one Boolean per section x day x start.
+//  - every section takes exactly one (day, start)
+//  - each section placement implies the occupancy cells it covers, and at most
+//    one section may occupy a cell (this rules out every overlap)
+//  - section time slot requirements restrict the candidate placements (unit
+//    clauses), course time slot requirements become a clause over matching placements
+class TimetableSatEncoder {
+public:
+    TimetableSatEncoder(const std::vector<Ref<Section>>& sections,
+                        const std::vector<std::shared_ptr<Requirement>>& requirements,
+                        const SatScheduleOptions& options = SatScheduleOptions());
+    
+    SatSolver::Result solve();
+    
+    // Build the schedule from the last satisfying assignment
+    std::shared_ptr<Schedule> decode() const;
+    
+    const SatSolver& getSolver() const;
+    
+private:
+    struct Candidate {
+        TimeSlot::Day day;
+        int start;
+        int var;
+    };
+    
+    std::vector<Ref<Section>> sections;
+    std::vector<std::shared_ptr<Requirement>> requirements;
+    SatScheduleOptions options;
+    SatSolver solver;
+    std::vector<std::vector<Candidate>> candidates;  // Per section
+    
+    void encode();
+    bool matches(const TimeSlot& required, TimeSlot::Day day, int start) const;
+};
+
+#endif // SAT_ENCODER_HPP 
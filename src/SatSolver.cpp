@@ -0,0 +1,488 @@
+#include "SatSolver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+SatSolver::SatSolver()
+    : propagationHead(0), varIncrement(1.0), clauseIncrement(1.0),
+      learntCount(0), maxLearnts(0.0), ok(true) {}
+
+int SatSolver::newVar() {
+    int var = static_cast<int>(assigns.size());
+    assigns.push_back(-1);
+    level.push_back(0);
+    reason.push_back(-1);
+    savedPhase.push_back(1);  // Try false first: most timetable variables end up false
+    activity.push_back(0.0);
+    seen.push_back(0);
+    heapIndex.push_back(-1);
+    watches.emplace_back();
+    watches.emplace_back();
+    heapInsert(var);
+    return var;
+}
+
+int SatSolver::numVars() const {
+    return static_cast<int>(assigns.size());
+}
+
+size_t SatSolver::numClauses() const {
+    return clauses.size();
+}
+
+const SatStats& SatSolver::getStats() const {
+    return stats;
+}
+
+bool SatSolver::modelValue(int var) const {
+    return var >= 0 && var < static_cast<int>(model.size()) && model[var];
+}
+
+// 1 = true, 0 = false, -1 = unassigned
+int SatSolver::value(int lit) const {
+    signed char assigned = assigns[varOf(lit)];
+    if (assigned < 0) return -1;
+    return assigned ^ (lit & 1);
+}
+
+int SatSolver::decisionLevel() const {
+    return static_cast<int>(trailLimits.size());
+}
+
+void SatSolver::enqueue(int lit, int reasonClause) {
+    int var = varOf(lit);
+    assigns[var] = (lit & 1) ? 0 : 1;
+    level[var] = decisionLevel();
+    reason[var] = reasonClause;
+    trail.push_back(lit);
+}
+
+void SatSolver::attachClause(int index) {
+    const Clause& clause = clauses[index];
+    watches[clause.lits[0]].push_back(index);
+    watches[clause.lits[1]].push_back(index);
+}
+
+bool SatSolver::addClause(std::vector<int> lits) {
+    if (!ok) return false;
+
+    // Normalize: drop duplicates and false literals, skip satisfied or tautological clauses
+    std::sort(lits.begin(), lits.end());
+    std::vector<int> kept;
+    for (size_t i = 0; i < lits.size(); i++) {
+        int lit = lits[i];
+        if (i > 0 && lit == lits[i - 1]) continue;
+        if (i > 0 && lit == negate(lits[i - 1])) return true;
+        int v = value(lit);
+        if (v == 1) return true;
+        if (v == 0) continue;
+        kept.push_back(lit);
+    }
+
+    if (kept.empty()) {
+        ok = false;
+        return false;
+    }
+
+    if (kept.size() == 1) {
+        enqueue(kept[0], -1);
+        if (propagate() != -1) {
+            ok = false;
+        }
+        return ok;
+    }
+
+    clauses.push_back(Clause{kept, false, 0.0});
+    attachClause(static_cast<int>(clauses.size()) - 1);
+    return true;
+}
+
+void SatSolver::addAtMostOne(const std::vector<int>& lits) {
+    if (lits.size() <= 1) return;
+
+    if (lits.size() <= 5) {
+        for (size_t i = 0; i < lits.size(); i++) {
+            for (size_t j = i + 1; j < lits.size(); j++) {
+                addClause({negate(lits[i]), negate(lits[j])});
+            }
+        }
+        return;
+    }
+
+    // Sequential counter: prefix[i] is true if any of lits[0..i] is true
+    std::vector<int> prefix;
+    for (size_t i = 0; i + 1 < lits.size(); i++) {
+        prefix.push_back(makeLit(newVar()));
+    }
+    addClause({negate(lits[0]), prefix[0]});
+    for (size_t i = 1; i + 1 < lits.size(); i++) {
+        addClause({negate(lits[i]), prefix[i]});
+        addClause({negate(prefix[i - 1]), prefix[i]});
+        addClause({negate(lits[i]), negate(prefix[i - 1])});
+    }
+    addClause({negate(lits.back()), negate(prefix.back())});
+}
+
+void SatSolver::addExactlyOne(const std::vector<int>& lits) {
+    addClause(lits);
+    addAtMostOne(lits);
+}
+
+// Returns the index of a conflicting clause, or -1
+int SatSolver::propagate() {
+    while (propagationHead < trail.size()) {
+        int falseLit = negate(trail[propagationHead++]);
+        std::vector<int>& watching = watches[falseLit];
+        stats.propagations++;
+
+        size_t i = 0, j = 0;
+        while (i < watching.size()) {
+            int index = watching[i++];
+            std::vector<int>& lits = clauses[index].lits;
+
+            // Make sure the false literal is lits[1]
+            if (lits[0] == falseLit) {
+                std::swap(lits[0], lits[1]);
+            }
+
+            // Clause already satisfied by the other watch
+            if (value(lits[0]) == 1) {
+                watching[j++] = index;
+                continue;
+            }
+
+            // Look for a new literal to watch
+            bool moved = false;
+            for (size_t k = 2; k < lits.size(); k++) {
+                if (value(lits[k]) != 0) {
+                    std::swap(lits[1], lits[k]);
+                    watches[lits[1]].push_back(index);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            // Clause is unit or conflicting
+            watching[j++] = index;
+            if (value(lits[0]) == 0) {
+                while (i < watching.size()) {
+                    watching[j++] = watching[i++];
+                }
+                watching.resize(j);
+                propagationHead = trail.size();
+                return index;
+            }
+            enqueue(lits[0], index);
+        }
+        watching.resize(j);
+    }
+    return -1;
+}
+
+// First-UIP conflict analysis
+void SatSolver::analyze(int conflict, std::vector<int>& learnt, int& backtrackLevel) {
+    learnt.assign(1, -1);
+    int pathCount = 0;
+    int lit = -1;
+    int index = static_cast<int>(trail.size()) - 1;
+    int clauseIndex = conflict;
+
+    do {
+        Clause& clause = clauses[clauseIndex];
+        if (clause.learnt) {
+            bumpClause(clauseIndex);
+        }
+
+        // Reason clauses keep the implied literal in lits[0]
+        for (size_t k = (lit == -1 ? 0 : 1); k < clause.lits.size(); k++) {
+            int q = clause.lits[k];
+            int var = varOf(q);
+            if (!seen[var] && level[var] > 0) {
+                bumpVar(var);
+                seen[var] = 1;
+                if (level[var] >= decisionLevel()) {
+                    pathCount++;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+        }
+
+        // Walk back to the next marked literal on the trail
+        while (!seen[varOf(trail[index--])]) {}
+        lit = trail[index + 1];
+        clauseIndex = reason[varOf(lit)];
+        seen[varOf(lit)] = 0;
+        pathCount--;
+    } while (pathCount > 0);
+
+    learnt[0] = negate(lit);
+
+    // Put the literal with the highest level in second position
+    backtrackLevel = 0;
+    if (learnt.size() > 1) {
+        size_t maxIndex = 1;
+        for (size_t k = 2; k < learnt.size(); k++) {
+            if (level[varOf(learnt[k])] > level[varOf(learnt[maxIndex])]) {
+                maxIndex = k;
+            }
+        }
+        std::swap(learnt[1], learnt[maxIndex]);
+        backtrackLevel = level[varOf(learnt[1])];
+    }
+
+    for (size_t k = 1; k < learnt.size(); k++) {
+        seen[varOf(learnt[k])] = 0;
+    }
+}
+
+void SatSolver::cancelUntil(int targetLevel) {
+    if (decisionLevel() <= targetLevel) return;
+
+    for (int i = static_cast<int>(trail.size()) - 1; i >= trailLimits[targetLevel]; i--) {
+        int var = varOf(trail[i]);
+        assigns[var] = -1;
+        reason[var] = -1;
+        savedPhase[var] = static_cast<char>(trail[i] & 1);
+        if (heapIndex[var] < 0) {
+            heapInsert(var);
+        }
+    }
+    trail.resize(trailLimits[targetLevel]);
+    trailLimits.resize(targetLevel);
+    propagationHead = trail.size();
+}
+
+int SatSolver::pickBranchLit() {
+    while (!heap.empty()) {
+        int var = heapRemoveMax();
+        if (assigns[var] < 0) {
+            return makeLit(var, savedPhase[var] != 0);
+        }
+    }
+    return -1;
+}
+
+void SatSolver::bumpVar(int var) {
+    activity[var] += varIncrement;
+    if (activity[var] > 1e100) {
+        // Rescale to avoid overflow
+        for (double& a : activity) a *= 1e-100;
+        varIncrement *= 1e-100;
+    }
+    if (heapIndex[var] >= 0) {
+        heapUp(heapIndex[var]);
+    }
+}
+
+void SatSolver::bumpClause(int index) {
+    clauses[index].activity += clauseIncrement;
+    if (clauses[index].activity > 1e20) {
+        for (Clause& clause : clauses) {
+            if (clause.learnt) clause.activity *= 1e-20;
+        }
+        clauseIncrement *= 1e-20;
+    }
+}
+
+// Drop the less active half of the learnt clauses. Only called at decision level 0,
+// where no learnt clause is needed as a reason for conflict analysis.
+void SatSolver::reduceLearnts() {
+    std::vector<double> activities;
+    for (const Clause& clause : clauses) {
+        if (clause.learnt && clause.lits.size() > 2) {
+            activities.push_back(clause.activity);
+        }
+    }
+    if (activities.empty()) return;
+
+    std::nth_element(activities.begin(), activities.begin() + activities.size() / 2, activities.end());
+    double threshold = activities[activities.size() / 2];
+
+    std::vector<int> newIndex(clauses.size(), -1);
+    std::vector<Clause> kept;
+    kept.reserve(clauses.size());
+    for (size_t i = 0; i < clauses.size(); i++) {
+        const Clause& clause = clauses[i];
+        if (clause.learnt && clause.lits.size() > 2 && clause.activity < threshold) {
+            stats.deletedClauses++;
+            learntCount--;
+            continue;
+        }
+        newIndex[i] = static_cast<int>(kept.size());
+        kept.push_back(std::move(clauses[i]));
+    }
+    clauses.swap(kept);
+
+    for (int& r : reason) {
+        if (r >= 0) r = newIndex[r];
+    }
+    for (auto& watching : watches) {
+        watching.clear();
+    }
+    for (size_t i = 0; i < clauses.size(); i++) {
+        attachClause(static_cast<int>(i));
+    }
+}
+
+// Luby restart sequence: 1 1 2 1 1 2 4 ...
+double SatSolver::luby(double y, int x) {
+    int size = 1, seq = 0;
+    while (size < x + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    return std::pow(y, seq);
+}
+
+SatSolver::Result SatSolver::solve(const SatLimits& limits) {
+    model.clear();
+    if (!ok) return UNSATISFIABLE;
+
+    if (propagate() != -1) {
+        ok = false;
+        return UNSATISFIABLE;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    maxLearnts = std::max(1000.0, clauses.size() / 3.0);
+    long conflictsAtStart = stats.conflicts;
+    int restartCount = 0;
+    long restartLimit = static_cast<long>(100 * luby(2.0, restartCount));
+    long conflictsSinceRestart = 0;
+    long loops = 0;
+    std::vector<int> learnt;
+
+    while (true) {
+        // Check the budget every so often
+        if ((++loops & 1023) == 0) {
+            bool outOfTime = limits.timeBudgetMs >= 0 &&
+                std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(limits.timeBudgetMs);
+            bool outOfConflicts = limits.maxConflicts >= 0 &&
+                stats.conflicts - conflictsAtStart >= limits.maxConflicts;
+            bool cancelled = limits.cancel && limits.cancel->load(std::memory_order_relaxed);
+            if (outOfTime || outOfConflicts || cancelled) {
+                cancelUntil(0);
+                return UNKNOWN;
+            }
+        }
+
+        int conflict = propagate();
+        if (conflict != -1) {
+            stats.conflicts++;
+            conflictsSinceRestart++;
+            if (decisionLevel() == 0) {
+                ok = false;
+                return UNSATISFIABLE;
+            }
+
+            int backtrackLevel;
+            analyze(conflict, learnt, backtrackLevel);
+            cancelUntil(backtrackLevel);
+
+            if (learnt.size() == 1) {
+                enqueue(learnt[0], -1);
+            } else {
+                clauses.push_back(Clause{learnt, true, 0.0});
+                int index = static_cast<int>(clauses.size()) - 1;
+                attachClause(index);
+                bumpClause(index);
+                enqueue(learnt[0], index);
+                learntCount++;
+                stats.learntClauses++;
+            }
+
+            varIncrement /= 0.95;
+            clauseIncrement /= 0.999;
+            continue;
+        }
+
+        if (conflictsSinceRestart >= restartLimit) {
+            // Restart, and prune learnt clauses while nothing is locked
+            cancelUntil(0);
+            stats.restarts++;
+            restartCount++;
+            restartLimit = static_cast<long>(100 * luby(2.0, restartCount));
+            conflictsSinceRestart = 0;
+            if (learntCount >= maxLearnts) {
+                reduceLearnts();
+                maxLearnts *= 1.1;
+            }
+            continue;
+        }
+
+        int next = pickBranchLit();
+        if (next == -1) {
+            // Every variable is assigned without conflict
+            model.resize(assigns.size());
+            for (size_t var = 0; var < assigns.size(); var++) {
+                model[var] = assigns[var] == 1;
+            }
+            cancelUntil(0);
+            return SATISFIABLE;
+        }
+
+        stats.decisions++;
+        trailLimits.push_back(static_cast<int>(trail.size()));
+        enqueue(next, -1);
+    }
+}
+
+// Heap helpers
+bool SatSolver::heapLess(int a, int b) const {
+    return activity[a] < activity[b];
+}
+
+void SatSolver::heapInsert(int var) {
+    heapIndex[var] = static_cast<int>(heap.size());
+    heap.push_back(var);
+    heapUp(heapIndex[var]);
+}
+
+int SatSolver::heapRemoveMax() {
+    int top = heap[0];
+    heap[0] = heap.back();
+    heapIndex[heap[0]] = 0;
+    heapIndex[top] = -1;
+    heap.pop_back();
+    if (!heap.empty()) {
+        heapDown(0);
+    }
+    return top;
+}
+
+void SatSolver::heapUp(int position) {
+    int var = heap[position];
+    while (position > 0) {
+        int parent = (position - 1) >> 1;
+        if (!heapLess(heap[parent], var)) break;
+        heap[position] = heap[parent];
+        heapIndex[heap[position]] = position;
+        position = parent;
+    }
+    heap[position] = var;
+    heapIndex[var] = position;
+}
+
+void SatSolver::heapDown(int position) {
+    int var = heap[position];
+    int size = static_cast<int>(heap.size());
+    while (2 * position + 1 < size) {
+        int child = 2 * position + 1;
+        if (child + 1 < size && heapLess(heap[child], heap[child + 1])) {
+            child++;
+        }
+        if (!heapLess(var, heap[child])) break;
+        heap[position] = heap[child];
+        heapIndex[heap[position]] = position;
+        position = child;
+    }
+    heap[position] = var;
+    heapIndex[var] = position;
+}
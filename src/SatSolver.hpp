@@ -0,0 +1,109 @@
+#ifndef SAT_SOLVER_HPP
+#define SAT_SOLVER_HPP
+
+#include <vector>
+#include <cstddef>
+#include <atomic>
+
+struct SatLimits {
+    int timeBudgetMs = -1;   // -1 = no time limit
+    long maxConflicts = -1;  // -1 = no conflict limit
+    const std::atomic<bool>* cancel = nullptr;  // Checked periodically, stops with UNKNOWN
+};
+
+struct SatStats {
+    long decisions = 0;
+    long propagations = 0;
+    long conflicts = 0;
+    long restarts = 0;
+    long learntClauses = 0;
+    long deletedClauses = 0;
+};
+
+// Small self-contained CDCL SAT solver (two watched literals, VSIDS branching
+// with phase saving, first-UIP clause learning, Luby restarts and learnt
+// clause deletion). Literals are encoded as 2 * var + (negated ? 1 : 0).
+class SatSolver {
+public:
+    enum Result { SATISFIABLE, UNSATISFIABLE, UNKNOWN };
+
+    SatSolver();
+
+    int newVar();
+    int numVars() const;
+    size_t numClauses() const;
+
+    static int makeLit(int var, bool negated = false) { return var * 2 + (negated ? 1 : 0); }
+    static int negate(int lit) { return lit ^ 1; }
+    static int varOf(int lit) { return lit >> 1; }
+
+    // Clauses can only be added before solving. Returns false once the formula is known unsatisfiable.
+    bool addClause(std::vector<int> lits);
+
+    // At most one of the literals is true (pairwise for small sets, sequential counter otherwise)
+    void addAtMostOne(const std::vector<int>& lits);
+    void addExactlyOne(const std::vector<int>& lits);
+
+    Result solve(const SatLimits& limits = SatLimits());
+
+    // Value of a variable in the last satisfying assignment
+    bool modelValue(int var) const;
+
+    const SatStats& getStats() const;
+
+private:
+    struct Clause {
+        std::vector<int> lits;  // lits[0] and lits[1] are the watched literals
+        bool learnt;
+        double activity;
+    };
+
+    std::vector<Clause> clauses;
+    std::vector<std::vector<int>> watches;  // Per literal: clauses watching it
+
+    std::vector<signed char> assigns;       // Per variable: -1 unassigned, 0 false, 1 true
+    std::vector<int> level;
+    std::vector<int> reason;                // Clause index that implied the variable, or -1
+    std::vector<char> savedPhase;           // Last polarity (1 = negated)
+    std::vector<double> activity;
+    std::vector<char> seen;
+    std::vector<bool> model;
+
+    std::vector<int> trail;
+    std::vector<int> trailLimits;
+    size_t propagationHead;
+
+    // Binary max-heap of unassigned variables ordered by activity
+    std::vector<int> heap;
+    std::vector<int> heapIndex;
+
+    double varIncrement;
+    double clauseIncrement;
+    size_t learntCount;
+    double maxLearnts;
+    bool ok;
+    SatStats stats;
+
+    int value(int lit) const;
+    int decisionLevel() const;
+    void enqueue(int lit, int reasonClause);
+    int propagate();
+    void analyze(int conflict, std::vector<int>& learnt, int& backtrackLevel);
+    void cancelUntil(int targetLevel);
+    int pickBranchLit();
+    void attachClause(int index);
+    void reduceLearnts();
+
+    void bumpVar(int var);
+    void bumpClause(int index);
+
+    bool heapLess(int a, int b) const;
+    void heapInsert(int var);
+    int heapRemoveMax();
+    void heapUp(int position);
+    void heapDown(int position);
+
+    static double luby(double y, int x);
+};
+
+#endif // SAT_SOLVER_HPP
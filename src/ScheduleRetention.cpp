@@ -0,0 +1,94 @@
+#include "ScheduleRetention.hpp"
+#include <algorithm>
+
+TopKSchedules::TopKSchedules(size_t capacity)
+    : capacity(capacity), nextSequence(0),
+      bestEntry{0.0, 0, nullptr} {}
+
+void TopKSchedules::setCapacity(size_t capacity) {
+    this->capacity = capacity;
+    
+    // Drop the worst schedules if we are now over capacity
+    while (heap.size() > capacity) {
+        std::pop_heap(heap.begin(), heap.end(), isBetter);
+        heap.pop_back();
+    }
+    if (heap.empty()) {
+        bestEntry = Entry{0.0, 0, nullptr};
+    }
+}
+
+size_t TopKSchedules::getCapacity() const {
+    return capacity;
+}
+
+bool TopKSchedules::isBetter(const Entry& a, const Entry& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    // On equal scores the earlier schedule wins
+    return a.sequence < b.sequence;
+}
+
+bool TopKSchedules::wouldRetain(double score) const {
+    if (capacity == 0) return false;
+    if (heap.size() < capacity) return true;
+    
+    // A newcomer always has a later sequence, so it must beat the worst strictly
+    return score > heap.front().score;
+}
+
+bool TopKSchedules::offer(std::shared_ptr<Schedule> schedule, double score) {
+    if (!schedule || !wouldRetain(score)) {
+        return false;
+    }
+    
+    Entry entry{score, nextSequence++, schedule};
+    
+    if (heap.size() >= capacity) {
+        // Evict the current worst schedule
+        std::pop_heap(heap.begin(), heap.end(), isBetter);
+        heap.pop_back();
+    }
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), isBetter);
+    
+    if (!bestEntry.schedule || isBetter(entry, bestEntry)) {
+        bestEntry = entry;
+    }
+    return true;
+}
+
+std::shared_ptr<Schedule> TopKSchedules::best() const {
+    return bestEntry.schedule;
+}
+
+double TopKSchedules::bestScore() const {
+    return bestEntry.score;
+}
+
+std::vector<std::shared_ptr<Schedule>> TopKSchedules::sorted() const {
+    std::vector<Entry> entries = heap;
+    std::sort(entries.begin(), entries.end(), isBetter);
+    
+    std::vector<std::shared_ptr<Schedule>> result;
+    result.reserve(entries.size());
+    for (const auto& entry : entries) {
+        result.push_back(entry.schedule);
+    }
+    return result;
+}
+
+size_t TopKSchedules::size() const {
+    return heap.size();
+}
+
+bool TopKSchedules::empty() const {
+    return heap.empty();
+}
+
+void TopKSchedules::clear() {
+    heap.clear();
+    nextSequence = 0;
+    bestEntry = Entry{0.0, 0, nullptr};
+}
@@ -0,0 +1,63 @@
+#ifndef SCHEDULE_RETENTION_HPP
+#define SCHEDULE_RETENTION_HPP
+
+#include "Models.hpp"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+// Keeps only the best K schedules seen so far according to a caller supplied score.
+// Internally a fixed-capacity min-heap: the worst retained schedule sits at the
+// front, so a new candidate either replaces it or is dropped immediately.
+class TopKSchedules {
+public:
+    using ScoreFunction = std::function<double(const Schedule&)>;
+    
+    explicit TopKSchedules(size_t capacity = 100);
+    
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+    
+    // Returns false if a schedule with this score would be dropped right away
+    bool wouldRetain(double score) const;
+    
+    // Offer a scored schedule, returns true if it was retained
+    bool offer(std::shared_ptr<Schedule> schedule, double score);
+    
+    std::shared_ptr<Schedule> best() const;
+    double bestScore() const;
+    
+    // Retained schedules ordered best first (ties keep discovery order)
+    std::vector<std::shared_ptr<Schedule>> sorted() const;
+    
+    // Visit retained schedules in heap order (used for duplicate checks)
+    template <typename Visitor>
+    bool anyOf(Visitor visitor) const {
+        for (const auto& entry : heap) {
+            if (visitor(*entry.schedule)) return true;
+        }
+        return false;
+    }
+    
+    size_t size() const;
+    bool empty() const;
+    void clear();
+    
+private:
+    struct Entry {
+        double score;
+        uint64_t sequence;
+        std::shared_ptr<Schedule> schedule;
+    };
+    
+    // Orders entries so that the worst one ends up at the heap front
+    static bool isBetter(const Entry& a, const Entry& b);
+    
+    size_t capacity;
+    std::vector<Entry> heap;
+    uint64_t nextSequence;
+    Entry bestEntry;
+};
+
+#endif // SCHEDULE_RETENTION_HPP 
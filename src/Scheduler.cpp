@@ -1,125 +1,682 @@
 #include "Scheduler.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
 #include <algorithm>
 #include <map>
 #include <set>
 #include <random>
-#include <iostream>
+#include <sstream>
+#include <climits>
+#include <unordered_map>
 
-Scheduler::Scheduler() {
+Scheduler::Scheduler()
+    : courseRegistry(&Course::getCode),
+      teacherRegistry(&Teacher::getId),
+      sectionRegistry(&Section::getId),
+      retainedSchedules(100),
+      scorerVersion(0) {
     clear();
 }
 
-void Scheduler::addCourse(std::shared_ptr<Course> course) {
-    if (std::find(courses.begin(), courses.end(), course) == courses.end()) {
-        courses.push_back(course);
+bool Scheduler::addCourse(Ref<Course> course) {
+    if (!courseRegistry.add(course)) {
+        return false;
     }
+    courses.push_back(course);
+    notifyChange(ModelChange::ADD_COURSE, course);
+    return true;
 }
 
-void Scheduler::addTeacher(std::shared_ptr<Teacher> teacher) {
-    if (std::find(teachers.begin(), teachers.end(), teacher) == teachers.end()) {
-        teachers.push_back(teacher);
+bool Scheduler::addTeacher(Ref<Teacher> teacher) {
+    if (!teacherRegistry.add(teacher)) {
+        return false;
     }
+    teachers.push_back(teacher);
+    notifyChange(ModelChange::ADD_TEACHER, nullptr, teacher);
+    return true;
 }
 
-void Scheduler::addSection(std::shared_ptr<Section> section) {
-    if (std::find(sections.begin(), sections.end(), section) == sections.end()) {
-        sections.push_back(section);
-        
-        // Add the section to its course
-        section->getCourse()->addSection(section);
-        
-        // Add the course to the teacher's list of courses
-        section->getTeacher()->addCourse(section->getCourse());
+void Scheduler::assignCourse(Ref<Teacher> teacher, Ref<Course> course) {
+    const auto& taught = teacher->getCourses();
+    if (std::find(taught.begin(), taught.end(), course) == taught.end()) {
+        teacher->addCourse(course);
+        notifyChange(ModelChange::ASSIGN_COURSE, course, teacher);
+    }
+}
+
+void Scheduler::removeCourse(Ref<Course> course) {
+    if (!courseRegistry.remove(course.get())) {
+        return;
+    }
+    courses.erase(std::remove(courses.begin(), courses.end(), course), courses.end());
+    auto owned = course->getSections();
+    for (const auto& section : owned) {
+        eraseSection(section);
+    }
+    for (const auto& teacher : teachers) {
+        teacher->removeCourse(course);
+    }
+    eraseRequirementsMentioning(course.get(), nullptr, nullptr);
+    notifyChange(ModelChange::REMOVE_COURSE, course);
+}
+
+void Scheduler::removeTeacher(Ref<Teacher> teacher) {
+    if (!teacherRegistry.remove(teacher.get())) {
+        return;
+    }
+    teachers.erase(std::remove(teachers.begin(), teachers.end(), teacher), teachers.end());
+    std::vector<Ref<Section>> taught;
+    for (const auto& section : sections) {
+        if (section->getTeacher() == teacher) {
+            taught.push_back(section);
+        }
+    }
+    for (const auto& section : taught) {
+        eraseSection(section);
+    }
+    eraseRequirementsMentioning(nullptr, teacher.get(), nullptr);
+    notifyChange(ModelChange::REMOVE_TEACHER, nullptr, teacher);
+}
+
+void Scheduler::removeSection(Ref<Section> section) {
+    if (sectionRegistry.contains(section.get())) {
+        eraseSection(section);
+        notifyChange(ModelChange::REMOVE_SECTION, nullptr, nullptr, section);
     }
 }
 
+void Scheduler::eraseSection(const Ref<Section>& section) {
+    if (!sectionRegistry.remove(section.get())) {
+        return;
+    }
+    sections.erase(std::remove(sections.begin(), sections.end(), section), sections.end());
+    section->getCourse()->removeSection(section);
+    eraseRequirementsMentioning(nullptr, nullptr, section.get());
+}
+
+void Scheduler::eraseRequirementsMentioning(const Course* course, const Teacher* teacher, const Section* section) {
+    auto mentions = [&](const std::shared_ptr<Requirement>& requirement) {
+        if (auto pin = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(requirement)) {
+            return pin->getSection().get() == section ||
+                   (course && pin->getSection()->getCourse().get() == course);
+        }
+        if (auto time = std::dynamic_pointer_cast<TimeSlotRequirement>(requirement)) {
+            return time->getCourse().get() == course;
+        }
+        if (auto required = std::dynamic_pointer_cast<TeacherRequirement>(requirement)) {
+            return required->getCourse().get() == course || required->getTeacher().get() == teacher;
+        }
+        return false;
+    };
+    auto dropped = std::remove_if(requirements.begin(), requirements.end(), mentions);
+    for (auto it = dropped; it != requirements.end(); ++it) {
+        requirementSet.erase(it->get());
+    }
+    requirements.erase(dropped, requirements.end());
+    pinsStale = true;
+}
+
+bool Scheduler::addSection(Ref<Section> section) {
+    if (!sectionRegistry.add(section)) {
+        return false;
+    }
+    sections.push_back(section);
+    
+    // Add the section to its course
+    section->getCourse()->addSection(section);
+    
+    // Add the course to the teacher's list of courses
+    section->getTeacher()->addCourse(section->getCourse());
+    
+    // A pin may have been added before its section
+    pinsStale = true;
+    notifyChange(ModelChange::ADD_SECTION, nullptr, nullptr, section);
+    return true;
+}
+
+void Scheduler::reserve(size_t moreCourses, size_t moreTeachers, size_t moreSections) {
+    courses.reserve(courses.size() + moreCourses);
+    teachers.reserve(teachers.size() + moreTeachers);
+    sections.reserve(sections.size() + moreSections);
+    courseRegistry.reserve(courseRegistry.handleBound() + moreCourses);
+    teacherRegistry.reserve(teacherRegistry.handleBound() + moreTeachers);
+    sectionRegistry.reserve(sectionRegistry.handleBound() + moreSections);
+}
+
 void Scheduler::addRequirement(std::shared_ptr<Requirement> requirement) {
-    if (std::find(requirements.begin(), requirements.end(), requirement) == requirements.end()) {
+    if (requirementSet.insert(requirement.get()).second) {
         requirements.push_back(requirement);
+        pinsStale = true;
+        
+        // A pin to a day and time can be repaired around, like an added section
+        auto pin = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(requirement);
+        bool placed = pin && pin->getTimeSlot().hasDay() && pin->getTimeSlot().hasStartTime();
+        noteEdit(placed ? pin->getSection() : nullptr);
+        if (changeListener) {
+            ModelChange change;
+            change.kind = ModelChange::ADD_REQUIREMENT;
+            change.requirement = requirement;
+            changeListener(change);
+        }
     }
 }
 
 void Scheduler::removeRequirement(std::shared_ptr<Requirement> requirement) {
-    auto it = std::find(requirements.begin(), requirements.end(), requirement);
-    if (it != requirements.end()) {
+    if (requirementSet.erase(requirement.get())) {
+        auto it = std::find(requirements.begin(), requirements.end(), requirement);
+        size_t index = static_cast<size_t>(it - requirements.begin());
         requirements.erase(it);
+        pinsStale = true;
+        noteEdit(nullptr);
+        if (changeListener) {
+            ModelChange change;
+            change.kind = ModelChange::REMOVE_REQUIREMENT;
+            change.requirement = requirement;
+            change.index = index;
+            changeListener(change);
+        }
+    }
+}
+
+void Scheduler::addPreference(const StudentPreference& preference) {
+    preferences.push_back(preference);
+    preferenceScorer = PreferenceScorer(preferences);
+    noteEdit(nullptr);
+    if (changeListener) {
+        ModelChange change;
+        change.kind = ModelChange::ADD_PREFERENCE;
+        change.preference = &preferences.back();
+        changeListener(change);
+    }
+}
+
+void Scheduler::removePreference(size_t index) {
+    if (index < preferences.size()) {
+        preferences.erase(preferences.begin() + index);
+        preferenceScorer = PreferenceScorer(preferences);
+        noteEdit(nullptr);
+        if (changeListener) {
+            ModelChange change;
+            change.kind = ModelChange::REMOVE_PREFERENCE;
+            change.index = index;
+            changeListener(change);
+        }
+    }
+}
+
+void Scheduler::setChangeListener(ChangeListener listener) {
+    changeListener = listener;
+}
+
+void Scheduler::noteEdit(const Ref<Section>& section) {
+    editedSection = section && (editsSinceSolve == 0 || editedSection == section) ? section : nullptr;
+    editsSinceSolve++;
+}
+
+void Scheduler::markSolved() {
+    editsSinceSolve = 0;
+    editedSection = nullptr;
+}
+
+void Scheduler::notifyChange(ModelChange::Kind kind, Ref<Course> course,
+                             Ref<Teacher> teacher, Ref<Section> section) {
+    noteEdit(kind == ModelChange::ADD_SECTION ? section : nullptr);
+    if (changeListener) {
+        ModelChange change;
+        change.kind = kind;
+        change.course = course;
+        change.teacher = teacher;
+        change.section = section;
+        changeListener(change);
     }
 }
 
+const std::vector<StudentPreference>& Scheduler::getPreferences() const {
+    return preferences;
+}
+
+const PreferenceScorer& Scheduler::getPreferenceScorer() const {
+    return preferenceScorer;
+}
+
 bool Scheduler::generateSchedule() {
+    return generateSchedule(SolveOptions());
+}
+
+bool Scheduler::generateSchedule(const SolveOptions& options) {
+    TRACE_SCOPE("Scheduler::generateSchedule", "solver");
+    solveContext = SolveContext();
+    solveContext.options = options;
+    solveContext.start = std::chrono::steady_clock::now();
+    solveContext.lastProgress = solveContext.start;
+    
+    // A memory budget limits how many schedules we can afford to keep, after the
+    // arena's candidates for one permutation
+    size_t retainedCapacity = retainedSchedules.getCapacity();
+    if (options.memoryBudgetBytes > 0) {
+        size_t working = std::min(options.memoryBudgetBytes, estimateArenaBytes());
+        size_t affordable = std::max<size_t>(1, (options.memoryBudgetBytes - working) / estimateScheduleBytes());
+        retainedSchedules.setCapacity(std::min(retainedCapacity, affordable));
+    }
+    size_t placedBefore = arena.getPlacedCount();
+    
+    // Unchanged inputs: hand back the remembered result
+    uint64_t fingerprint = computeFingerprint(options);
+    CachedSolve cached;
+    auto findSection = [this](const std::string& id) { return sectionRegistry.find(id); };
+    if (solveCache.lookup(fingerprint, findSection, cached)) {
+        possibleSchedules = cached.schedules;
+        currentSchedule = cached.currentIndex >= 0 ? possibleSchedules[cached.currentIndex] : nullptr;
+        solveContext.progress.validFound = static_cast<long>(possibleSchedules.size());
+        retainedSchedules.setCapacity(retainedCapacity);
+        solveContext.stats.fromCache = true;
+        markSolved();
+        finishStats();
+        reportProgress(true);
+        return cached.found;
+    }
+    
+    const std::atomic<bool>* cancel = options.cancel.get();
+    bool found = false;
+    
+    switch (options.mode) {
+        case SolverMode::LOCAL_SEARCH: {
+            LocalSearchOptions localSearch = options.localSearch;
+            if (options.timeBudgetMs >= 0) {
+                localSearch.timeBudgetMs = std::min<long>(localSearch.timeBudgetMs, options.timeBudgetMs);
+            }
+            localSearch.cancel = cancel;
+            found = generateScheduleLocalSearch(localSearch);
+            break;
+        }
+        case SolverMode::SAT: {
+            SatScheduleOptions sat = options.sat;
+            if (options.timeBudgetMs >= 0) {
+                sat.timeBudgetMs = sat.timeBudgetMs < 0 ? options.timeBudgetMs
+                                                        : std::min(sat.timeBudgetMs, options.timeBudgetMs);
+            }
+            sat.cancel = cancel;
+            found = generateScheduleSAT(sat);
+            break;
+        }
+        case SolverMode::ENUMERATE:
+        default:
+            found = enumerateSchedules();
+            break;
+    }
+    
+    // Every candidate is gone by now, the retained schedules were promoted
+    SLOG_DEBUG("solver", "Placed " << arena.getPlacedCount() - placedBefore << " candidate sections in the arena");
+    arena.release();
+    
+    // The mode specific solvers stop on their own, so work out why afterwards
+    if (solveContext.status == SolveStatus::COMPLETED) {
+        if (cancel && cancel->load()) {
+            solveContext.status = SolveStatus::CANCELLED;
+        } else if (options.timeBudgetMs >= 0 && remainingBudgetMs() == 0) {
+            solveContext.status = SolveStatus::TIMED_OUT;
+        }
+    }
+    
+    retainedSchedules.setCapacity(retainedCapacity);
+    
+    // Runs cut short by a clock or a cancel, or that the solver itself could not
+    // settle, are not reproducible, so they are not remembered
+    bool reproducible = solveContext.conclusive && (solveContext.status == SolveStatus::COMPLETED ||
+                                                    solveContext.status == SolveStatus::LIMIT_REACHED);
+    if (reproducible) {
+        cached = CachedSolve();
+        cached.found = found;
+        cached.schedules = possibleSchedules;
+        for (size_t i = 0; i < possibleSchedules.size(); i++) {
+            if (possibleSchedules[i] == currentSchedule) {
+                cached.currentIndex = static_cast<int>(i);
+                break;
+            }
+        }
+        solveCache.store(fingerprint, cached);
+    }
+    
+    markSolved();
+    finishStats();
+    reportProgress(true);
+    return found;
+}
+
+void Scheduler::setSolveCacheCapacity(size_t entries) {
+    solveCache.setCapacity(entries);
+}
+
+void Scheduler::setSolveCacheDirectory(const std::string& directory) {
+    solveCache.setDirectory(directory);
+}
+
+// Hash of everything that can change the outcome of a solve
+uint64_t Scheduler::computeFingerprint(const SolveOptions& options) const {
+    Fingerprint fingerprint;
+    auto addSlot = [&fingerprint](const TimeSlot& timeSlot) {
+        fingerprint.add(static_cast<long long>(timeSlot.getDay()))
+                   .add(static_cast<long long>(timeSlot.getStartHour()))
+                   .add(static_cast<long long>(timeSlot.getStartMinute()))
+                   .add(static_cast<long long>(timeSlot.getDurationMinutes()));
+    };
+    
+    fingerprint.add(static_cast<long long>(courses.size()));
+    for (const auto& course : courses) {
+        fingerprint.add(course->getCode()).add(course->getName()).add(static_cast<long long>(course->getCredits()));
+    }
+    fingerprint.add(static_cast<long long>(teachers.size()));
+    for (const auto& teacher : teachers) {
+        fingerprint.add(teacher->getId()).add(teacher->getName());
+    }
+    fingerprint.add(static_cast<long long>(sections.size()));
+    for (const auto& section : sections) {
+        fingerprint.add(section->getId())
+                   .add(section->getCourse()->getCode())
+                   .add(section->getTeacher()->getId());
+        addSlot(section->getTimeSlot());
+    }
+    
+    // Requirements by the ids they refer to, descriptions use display names that need not be unique
+    fingerprint.add(static_cast<long long>(requirements.size()));
+    for (const auto& requirement : requirements) {
+        if (auto pin = dynamic_cast<const SectionTimeSlotRequirement*>(requirement.get())) {
+            fingerprint.add("pin").add(pin->getSection()->getId());
+            addSlot(pin->getTimeSlot());
+        } else if (auto time = dynamic_cast<const TimeSlotRequirement*>(requirement.get())) {
+            fingerprint.add("require-time").add(time->getCourse()->getCode());
+            addSlot(time->getTimeSlot());
+        } else if (auto teacher = dynamic_cast<const TeacherRequirement*>(requirement.get())) {
+            fingerprint.add("require-teacher").add(teacher->getCourse()->getCode())
+                       .add(teacher->getTeacher()->getId());
+        } else {
+            fingerprint.add(requirement->getDescription());
+        }
+    }
+    fingerprint.add(static_cast<long long>(preferences.size()));
+    for (const auto& preference : preferences) {
+        fingerprint.add(static_cast<long long>(preference.type)).add(preference.courseCode).add(preference.teacherId)
+                   .add(static_cast<long long>(preference.day)).add(static_cast<long long>(preference.startHour))
+                   .add(static_cast<long long>(preference.endHour)).add(preference.weight);
+    }
+    
+    // Solver settings (callbacks and the cancel token do not change the result)
+    fingerprint.add(static_cast<long long>(scorerVersion))
+               .add(static_cast<long long>(retainedSchedules.getCapacity()))
+               .add(static_cast<long long>(options.mode))
+               .add(static_cast<long long>(options.timeBudgetMs))
+               .add(static_cast<long long>(options.maxSchedules))
+               .add(static_cast<long long>(options.memoryBudgetBytes));
+    if (options.mode == SolverMode::LOCAL_SEARCH) {
+        const LocalSearchOptions& ls = options.localSearch;
+        fingerprint.add(static_cast<long long>(ls.timeBudgetMs)).add(static_cast<long long>(ls.maxIterations))
+                   .add(ls.initialTemperature).add(ls.coolingRate).add(ls.minTemperature).add(ls.conflictPenalty)
+                   .add(static_cast<long long>(ls.earliestStartMinutes)).add(static_cast<long long>(ls.latestEndMinutes))
+                   .add(static_cast<long long>(ls.startStepMinutes)).add(static_cast<long long>(ls.seed));
+    } else if (options.mode == SolverMode::SAT) {
+        const SatScheduleOptions& sat = options.sat;
+        fingerprint.add(static_cast<long long>(sat.earliestStartMinutes)).add(static_cast<long long>(sat.latestEndMinutes))
+                   .add(static_cast<long long>(sat.startStepMinutes))
+                   .add(static_cast<long long>(sat.timeBudgetMs)).add(static_cast<long long>(sat.maxConflicts));
+    }
+    
+    return fingerprint.value();
+}
+
+SolveStatus Scheduler::getLastSolveStatus() const {
+    return solveContext.status;
+}
+
+const SolveProgress& Scheduler::getLastSolveProgress() const {
+    return solveContext.progress;
+}
+
+const SolverStats& Scheduler::getLastSolverStats() const {
+    return solveContext.stats;
+}
+
+void Scheduler::finishStats() {
+    solveContext.stats.totalNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - solveContext.start).count();
+    SLOG_DEBUG("stats", solveContext.stats.toString());
+}
+
+long Scheduler::remainingBudgetMs() const {
+    if (solveContext.options.timeBudgetMs < 0) {
+        return -1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - solveContext.start).count();
+    return std::max<long>(0, solveContext.options.timeBudgetMs - elapsed);
+}
+
+// Helper method to check the budget and cancellation token (also reports progress)
+bool Scheduler::shouldStop() {
+    if (solveContext.status != SolveStatus::COMPLETED) {
+        return true;
+    }
+    
+    const SolveOptions& options = solveContext.options;
+    if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+        solveContext.status = SolveStatus::CANCELLED;
+    } else if (options.maxSchedules >= 0 && solveContext.progress.validFound >= options.maxSchedules) {
+        solveContext.status = SolveStatus::LIMIT_REACHED;
+    } else if (options.timeBudgetMs >= 0 && remainingBudgetMs() == 0) {
+        solveContext.status = SolveStatus::TIMED_OUT;
+    }
+    
+    reportProgress(false);
+    return solveContext.status != SolveStatus::COMPLETED;
+}
+
+void Scheduler::reportProgress(bool force) {
+    const SolveOptions& options = solveContext.options;
+    auto now = std::chrono::steady_clock::now();
+    
+    SolveProgress& progress = solveContext.progress;
+    progress.elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - solveContext.start).count();
+    if (!retainedSchedules.empty()) {
+        progress.hasBest = true;
+        progress.bestScore = retainedSchedules.bestScore();
+    } else if (!possibleSchedules.empty()) {
+        progress.hasBest = true;
+        progress.bestScore = scoreSchedule(*possibleSchedules[0]);
+    }
+    
+    if (!options.onProgress) {
+        return;
+    }
+    if (!force && now - solveContext.lastProgress < std::chrono::milliseconds(options.progressIntervalMs)) {
+        return;
+    }
+    solveContext.lastProgress = now;
+    options.onProgress(progress);
+}
+
+size_t Scheduler::estimateScheduleBytes() const {
+    // Each retained section is a pooled Section (holding its TimeSlot) in a chunk slot.
+    // Schedules that share chunks cost less, so this is an upper bound.
+    size_t perSection = sizeof(Ref<Section>) + sizeof(Section) + 48;
+    return sizeof(Schedule) + sections.size() * perSection;
+}
+
+size_t Scheduler::estimateArenaBytes() const {
+    // A base packing plus three variations per section, before the arena is released
+    return 4 * sections.size() * sizeof(Section);
+}
+
+// Helper method to enumerate PQ-tree permutations and their variations
+bool Scheduler::enumerateSchedules() {
     // Clear any existing schedules
     possibleSchedules.clear();
+    retainedSchedules.clear();
     currentSchedule = nullptr;
     
     // Instead of grouping sections by course, use all sections
-    std::vector<std::shared_ptr<Section>> allSections = sections;
+    std::vector<Ref<Section>> allSections = sections;
+    
+    SolverStats& stats = solveContext.stats;
     
     // Create a PQ tree for time ordering
     PQTree tree;
-    tree.buildTimeOrderedTree(allSections);
+    {
+        PhaseTimer timer(stats, SolvePhase::TREE_BUILD);
+        tree.buildTimeOrderedTree(allSections);
+    }
     
     // Get all valid permutations
-    auto permutations = tree.getFrontiers();
+    std::vector<std::vector<std::string>> permutations;
+    {
+        PhaseTimer timer(stats, SolvePhase::ENUMERATION);
+        permutations = tree.getFrontiers();
+    }
+    
+    // Each permutation gives a base schedule plus 3 variations per unpinned section
+    long flexibleCount = 0;
+    for (const auto& section : sections) {
+        if (!findSectionRequirement(*section)) {
+            flexibleCount++;
+        }
+    }
+    solveContext.progress.candidatesTotal = static_cast<long>(permutations.size()) * (1 + 3 * flexibleCount);
+    
+    // Sections behind each leaf label. Sections of the same course and teacher with the
+    // same time share a label, so each occurrence in a permutation takes the next one.
+    std::unordered_map<std::string, std::vector<int>> sectionsByLabel;
+    for (size_t i = 0; i < allSections.size(); i++) {
+        std::string sectionLabel = allSections[i]->getCourse()->getCode() + " (" + 
+                                 allSections[i]->getTeacher()->getName() + ", " +
+                                 allSections[i]->getTimeSlot().toString() + ")";
+        sectionsByLabel[sectionLabel].push_back(static_cast<int>(i));
+    }
     
     // For each permutation, try to assign start times
+    std::unordered_map<const std::vector<int>*, size_t> labelUses;
     for (const auto& permutation : permutations) {
+        if (shouldStop()) {
+            break;
+        }
+        
+        stats.permutationsEnumerated++;
+        
         // Convert string permutation to section indices
         std::vector<int> sectionIndices;
-        for (const auto& label : permutation) {
-            // Find matching section
-            for (size_t i = 0; i < allSections.size(); i++) {
-                std::string sectionLabel = allSections[i]->getCourse()->getCode() + " (" + 
-                                         allSections[i]->getTeacher()->getName() + ", " +
-                                         allSections[i]->getTimeSlot()->toString() + ")";
-                
-                // Also check with "Leaf: " prefix (as PQ Tree might add this)
-                if (label == sectionLabel || label == "Leaf: " + sectionLabel) {
-                    sectionIndices.push_back(i);
-                    break;
+        {
+            PhaseTimer timer(stats, SolvePhase::ENUMERATION);
+            labelUses.clear();
+            for (const auto& label : permutation) {
+                // Also accept the "Leaf: " prefix (as PQ Tree might add this)
+                static const std::string leafPrefix = "Leaf: ";
+                auto it = sectionsByLabel.find(label);
+                if (it == sectionsByLabel.end() && label.compare(0, leafPrefix.size(), leafPrefix) == 0) {
+                    it = sectionsByLabel.find(label.substr(leafPrefix.size()));
+                }
+                if (it == sectionsByLabel.end()) {
+                    continue;
+                }
+                size_t& used = labelUses[&it->second];
+                if (used < it->second.size()) {
+                    sectionIndices.push_back(it->second[used++]);
                 }
             }
         }
         
         // Skip if we couldn't map all labels to sections
         if (sectionIndices.size() != permutation.size()) {
+            stats.reject(RejectReason::UNMAPPED_PERMUTATION);
             continue;
         }
         
         // Create base schedule
-        auto baseSchedule = tryCreateScheduleWithTimes(sectionIndices);
-        if (baseSchedule.getSections().size() > 0) {
-            // The base schedule is valid, so add it
-            possibleSchedules.push_back(std::make_shared<Schedule>(baseSchedule));
-            
-            // Now create variations for sections without requirements
-            createScheduleVariations(baseSchedule);
+        solveContext.progress.candidatesTried++;
+        {
+            auto baseSchedule = tryCreateScheduleWithTimes(sectionIndices);
+            if (baseSchedule.getSections().size() > 0) {
+                // The base schedule is valid, so offer it. It leaves the arena right away
+                // so that the variations retained below share its chunks.
+                auto sharedBase = SolveArena::promote(baseSchedule);
+                retainSchedule(sharedBase);
+                
+                // Now create variations for sections without requirements
+                createScheduleVariations(sharedBase);
+            } else {
+                stats.reject(RejectReason::UNREPAIRABLE_PACKING);
+            }
         }
+        
+        // What this permutation kept was promoted, so the arena only holds one
+        // permutation's candidates at a time
+        arena.release();
     }
     
-    // Debug output
-    std::cout << "Generated " << possibleSchedules.size() << " valid schedules." << std::endl;
+    // Only the retained schedules survive, best first
+    possibleSchedules = retainedSchedules.sorted();
+    retainedSchedules.clear();
     
-    // Print a summary of each schedule
-    int idx = 1;
-    for (const auto& schedule : possibleSchedules) {
-        std::cout << "Schedule " << idx++ << ":\n";
-        for (const auto& section : schedule->getSections()) {
-            std::cout << "  " << section->getCourse()->getCode() 
-                     << " (" << section->getTeacher()->getName() 
-                     << ", " << section->getTimeSlot()->toString() << ")\n";
+    SLOG_DEBUG("solver", "Retained " << possibleSchedules.size() << " valid schedules");
+    
+    // Summary of each retained schedule (opt-in, this is by far the bulkiest output)
+    if (Logger::enabled(LogLevel::TRACE)) {
+        int idx = 1;
+        for (const auto& schedule : possibleSchedules) {
+            std::ostringstream summary;
+            summary << "Schedule " << idx++ << ":";
+            for (const auto& section : schedule->getSections()) {
+                summary << "\n  " << section->getCourse()->getCode()
+                        << " (" << section->getTeacher()->getName()
+                        << ", " << section->getTimeSlot().toString() << ")";
+            }
+            Logger::write(LogLevel::TRACE, "solver", summary.str());
         }
-        std::cout << std::endl;
     }
     
     // Find a schedule that satisfies all requirements
     return findSatisfyingSchedule();
 }
 
+bool Scheduler::generateScheduleSAT(const SatScheduleOptions& options) {
+    // Clear any existing schedules
+    possibleSchedules.clear();
+    retainedSchedules.clear();
+    currentSchedule = nullptr;
+    
+    if (sections.empty()) {
+        return false;
+    }
+    
+    TimetableSatEncoder encoder(sections, requirements, options);
+    SatSolver::Result result = encoder.solve();
+    
+    const SatStats& stats = encoder.getSolver().getStats();
+    solveContext.progress.candidatesTried += stats.decisions;
+    SLOG_DEBUG("sat", encoder.getSolver().numVars() << " vars, "
+              << encoder.getSolver().numClauses() << " clauses, "
+              << stats.conflicts << " conflicts, " << stats.restarts << " restarts");
+    
+    if (result != SatSolver::SATISFIABLE) {
+        SLOG_INFO("sat", (result == SatSolver::UNSATISFIABLE ? "No feasible schedule exists"
+                                                            : "Budget exhausted"));
+        // UNKNOWN only says the budget ran out, a longer run may still find a schedule
+        solveContext.conclusive = result == SatSolver::UNSATISFIABLE;
+        return false;
+    }
+    
+    auto schedule = encoder.decode();
+    if (!schedule->hasConflicts()) {
+        retainSchedule(schedule);
+    }
+    
+    possibleSchedules = retainedSchedules.sorted();
+    retainedSchedules.clear();
+    
+    return findSatisfyingSchedule();
+}
+
 // Helper method to generate all combinations of sections (one per course)
 void Scheduler::generateCourseSelections(
-    const std::map<std::string, std::vector<std::shared_ptr<Section>>>& sectionsByCourse,
-    std::vector<std::shared_ptr<Section>> current,
-    std::vector<std::vector<std::shared_ptr<Section>>>& result) {
+    const std::map<std::string, std::vector<Ref<Section>>>& sectionsByCourse,
+    std::vector<Ref<Section>> current,
+    std::vector<std::vector<Ref<Section>>>& result) {
     
     // If we've processed all courses, add this combination to the result
     if (current.size() == sectionsByCourse.size()) {
@@ -141,22 +698,59 @@ void Scheduler::generateCourseSelections(
 
 // Helper method to try creating a schedule with assigned start times
 Schedule Scheduler::tryCreateScheduleWithTimes(const std::vector<int>& permutation) {
+    TRACE_SCOPE("Scheduler::tryCreateScheduleWithTimes", "solver");
+    SolverStats& stats = solveContext.stats;
     Schedule schedule;
-    std::map<std::string, std::shared_ptr<Section>> sectionsById;
-
-    // Populate the map for quick section lookup
-    for (const auto& section : sections) {
-        sectionsById[section->getId()] = section;
+    {
+        PhaseTimer timer(stats, SolvePhase::PACKING);
+        schedule = packSections(permutation);
     }
+    
+    // Check if the schedule has conflicts
+    bool conflicted;
+    {
+        PhaseTimer timer(stats, SolvePhase::CONFLICT_CHECK);
+        conflicted = schedule.hasConflicts();
+    }
+    if (conflicted) {
+        stats.packingFailures++;
+        PhaseTimer timer(stats, SolvePhase::PACKING);
+        
+        // Try to turn the near miss into a feasible schedule before giving up
+        std::vector<bool> fixed;
+        for (const auto& section : schedule.getSections()) {
+            fixed.push_back(findSectionRequirement(*section) != nullptr);
+        }
+        
+        // Seed from the permutation so repeated runs give the same result
+        RepairOptions options;
+        options.seed = 1;
+        for (size_t i = 0; i < permutation.size(); i++) {
+            options.seed = options.seed * 31 + permutation[i];
+        }
+        if (options.seed == 0) options.seed = 1;
+        
+        MinConflictsRepair repair(schedule.getSections().toVector(), fixed, options);
+        auto repaired = repair.run();
+        
+        // Return an empty schedule if the conflicts could not be repaired
+        return repaired ? *repaired : Schedule();
+    }
+    
+    return schedule;
+}
 
-    std::vector<std::shared_ptr<Section>> selectedSections;
+// Helper method to greedily assign days and start times (may leave conflicts)
+Schedule Scheduler::packSections(const std::vector<int>& permutation) {
+    Schedule schedule;
+    std::vector<Ref<Section>> selectedSections;
     for (int idx : permutation) {
         selectedSections.push_back(sections[idx]);
     }
 
     // First, identify sections that have specific time requirements
-    std::vector<std::shared_ptr<Section>> sectionsWithRequirements;
-    std::vector<std::shared_ptr<Section>> sectionsWithoutRequirements;
+    std::vector<Ref<Section>> sectionsWithRequirements;
+    std::vector<Ref<Section>> sectionsWithoutRequirements;
 
     // Track the latest end time for each day to avoid conflicts
     std::map<TimeSlot::Day, int> latestEndTimeByDay;
@@ -166,67 +760,43 @@ Schedule Scheduler::tryCreateScheduleWithTimes(const std::vector<int>& permutati
 
     // Check requirements and separate sections that have specific time requirements
     for (const auto& section : selectedSections) {
-        bool hasSpecificRequirement = false;
-        
-        for (const auto& req : requirements) {
-            // Check if this is a SectionTimeSlotRequirement for this section
-            auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(req);
-            if (sectionReq && sectionReq->getSection()->getId() == section->getId()) {
-                sectionsWithRequirements.push_back(section);
-                hasSpecificRequirement = true;
-                break;
-            }
-        }
-        
-        if (!hasSpecificRequirement) {
+        if (findSectionRequirement(*section)) {
+            sectionsWithRequirements.push_back(section);
+        } else {
             sectionsWithoutRequirements.push_back(section);
         }
     }
 
     // First, schedule sections with specific time requirements
     for (const auto& section : sectionsWithRequirements) {
-        // Find the matching requirement for this section
-        for (const auto& req : requirements) {
-            auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(req);
-            if (sectionReq && sectionReq->getSection()->getId() == section->getId()) {
-                auto reqTimeSlot = sectionReq->getTimeSlot();
-                
-                // Get the required day and time
-                TimeSlot::Day day = reqTimeSlot->getDay();
-                int startTime = reqTimeSlot->getStartHour() * 60 + reqTimeSlot->getStartMinute();
-                int duration = section->getTimeSlot()->getDurationMinutes();
-                int endTime = startTime + duration;
-                
-                // Update the latest end time for this day
-                latestEndTimeByDay[day] = std::max(latestEndTimeByDay[day], endTime);
-                
-                // Create a new TimeSlot with the required day and time
-                auto timeSlot = std::make_shared<TimeSlot>(
-                    section->getTimeSlot()->getDurationMinutes(),
-                    day, 
-                    reqTimeSlot->getStartHour(), 
-                    reqTimeSlot->getStartMinute()
-                );
-                
-                // Create a new section with the assigned time slot
-                auto scheduleSection = std::make_shared<Section>(
-                    section->getId(),
-                    section->getCourse(),
-                    section->getTeacher(),
-                    timeSlot
-                );
-                
-                schedule.addSection(scheduleSection);
-                break;
-            }
-        }
+        auto reqTimeSlot = findSectionRequirement(*section)->getTimeSlot();
+        
+        // Get the required day and time
+        TimeSlot::Day day = reqTimeSlot.getDay();
+        int startTime = reqTimeSlot.getStartHour() * 60 + reqTimeSlot.getStartMinute();
+        int duration = section->getTimeSlot().getDurationMinutes();
+        int endTime = startTime + duration;
+        
+        // Update the latest end time for this day
+        latestEndTimeByDay[day] = std::max(latestEndTimeByDay[day], endTime);
+        
+        // Create a new TimeSlot with the required day and time
+        TimeSlot timeSlot(
+            section->getTimeSlot().getDurationMinutes(),
+            day, 
+            reqTimeSlot.getStartHour(), 
+            reqTimeSlot.getStartMinute()
+        );
+        
+        // Create a new section with the assigned time slot
+        schedule.addSection(arena.place(*section, timeSlot));
     }
 
     // Now schedule the remaining sections without specific requirements
     // Sort by duration (longest first) for better packing
     std::sort(sectionsWithoutRequirements.begin(), sectionsWithoutRequirements.end(),
         [](const auto& a, const auto& b) {
-            return a->getTimeSlot()->getDurationMinutes() > b->getTimeSlot()->getDurationMinutes();
+            return a->getTimeSlot().getDurationMinutes() > b->getTimeSlot().getDurationMinutes();
         }
     );
 
@@ -244,7 +814,7 @@ Schedule Scheduler::tryCreateScheduleWithTimes(const std::vector<int>& permutati
         
         // Assign this section to the day with the earliest end time
         int startTime = latestEndTimeByDay[selectedDay];
-        int duration = section->getTimeSlot()->getDurationMinutes();
+        int duration = section->getTimeSlot().getDurationMinutes();
         int endTime = startTime + duration;
         
         // Update the latest end time for this day
@@ -255,31 +825,212 @@ Schedule Scheduler::tryCreateScheduleWithTimes(const std::vector<int>& permutati
         int startMinute = startTime % 60;
         
         // Create a new TimeSlot with the assigned day and time
-        auto timeSlot = std::make_shared<TimeSlot>(
-            section->getTimeSlot()->getDurationMinutes(),
+        TimeSlot timeSlot(
+            section->getTimeSlot().getDurationMinutes(),
             selectedDay,
             startHour,
             startMinute
         );
         
         // Create a new section with the assigned time slot
-        auto scheduleSection = std::make_shared<Section>(
-            section->getId(),
-            section->getCourse(),
-            section->getTeacher(),
-            timeSlot
-        );
+        schedule.addSection(arena.place(*section, timeSlot));
+    }
+    
+    return schedule;
+}
+
+// Helper method to find the time slot requirement pinning a section, if any
+std::shared_ptr<SectionTimeSlotRequirement> Scheduler::findSectionRequirement(const Section& section) const {
+    if (pinsStale) {
+        // First pin wins, as with the old linear scan
+        pinsByHandle.assign(sectionRegistry.handleBound(), nullptr);
+        for (auto it = requirements.rbegin(); it != requirements.rend(); ++it) {
+            auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(*it);
+            if (!sectionReq) continue;
+            EntityHandle handle = sectionRegistry.findHandle(sectionReq->getSection()->getId());
+            if (handle != NO_HANDLE) {
+                pinsByHandle[handle] = sectionReq;
+            }
+        }
+        pinsStale = false;
+    }
+    
+    EntityHandle handle = section.getHandle();
+    if (handle == NO_HANDLE) {
+        // Not one of ours (or copied from one before it was added): go by id
+        handle = sectionRegistry.findHandle(section.getId());
+    }
+    return handle < pinsByHandle.size() ? pinsByHandle[handle] : nullptr;
+}
+
+bool Scheduler::generateScheduleLocalSearch(const LocalSearchOptions& options) {
+    // Clear any existing schedules
+    possibleSchedules.clear();
+    retainedSchedules.clear();
+    currentSchedule = nullptr;
+    
+    if (sections.empty()) {
+        return false;
+    }
+    
+    // Seed the search with the greedy packing of all sections in their given order
+    std::vector<int> order;
+    for (size_t i = 0; i < sections.size(); i++) {
+        order.push_back(static_cast<int>(i));
+    }
+    LocalSearchResult result;
+    {
+        Schedule seed = packSections(order);
         
-        schedule.addSection(scheduleSection);
+        // Sections pinned by a requirement keep their time
+        std::vector<bool> fixed;
+        for (const auto& section : seed.getSections()) {
+            fixed.push_back(findSectionRequirement(*section) != nullptr);
+        }
+        
+        LocalSearchSolver solver(seed.getSections().toVector(), fixed, preferenceScorer, options);
+        result = solver.run();
     }
     
-    // Check if the schedule has conflicts
-    if (schedule.hasConflicts()) {
-        // Return an empty schedule if there are conflicts
-        return Schedule();
+    // The seed was packed in the arena, the best schedule is built from pooled copies
+    arena.release();
+    solveContext.progress.candidatesTried += result.iterations;
+    
+    // Only a seeded search that ran its full iteration count gives the same answer again
+    solveContext.conclusive = options.seed != 0 && !result.stoppedEarly;
+    
+    SLOG_DEBUG("local-search", result.iterations << " iterations, "
+              << result.acceptedMoves << " accepted, best has "
+              << result.bestConflicts << " conflicts");
+    
+    if (result.best && !result.best->hasConflicts()) {
+        retainSchedule(result.best);
     }
     
-    return schedule;
+    possibleSchedules = retainedSchedules.sorted();
+    retainedSchedules.clear();
+    
+    return findSatisfyingSchedule();
+}
+
+bool Scheduler::resolveAfterEdits(const SolveOptions& options) {
+    if (editedSection && currentSchedule) {
+        return resolveIncrementally(editedSection, options);
+    }
+    return generateSchedule(options);
+}
+
+Ref<Section> Scheduler::getRepairableEdit() const {
+    return currentSchedule ? editedSection : nullptr;
+}
+
+bool Scheduler::resolveIncrementally(Ref<Section> changedSection, const SolveOptions& options,
+                                     const RepairOptions& repairOptions) {
+    // Nothing to build on yet
+    if (!currentSchedule || !changedSection) {
+        return generateSchedule(options);
+    }
+    
+    TRACE_SCOPE("Scheduler::resolveIncrementally", "solver");
+    solveContext = SolveContext();
+    solveContext.options = options;
+    solveContext.start = std::chrono::steady_clock::now();
+    solveContext.lastProgress = solveContext.start;
+    
+    // Where every section currently sits, by handle
+    std::vector<Ref<Section>> placedByHandle(sectionRegistry.handleBound());
+    for (const auto& placed : currentSchedule->getSections()) {
+        EntityHandle handle = placed->getHandle() != NO_HANDLE ? placed->getHandle()
+                                                               : sectionRegistry.findHandle(placed->getId());
+        if (handle < placedByHandle.size()) {
+            placedByHandle[handle] = placed;
+        }
+    }
+    
+    std::vector<Ref<Section>> working;
+    std::vector<bool> pinned;
+    size_t changedIndex = sections.size();
+    
+    for (const auto& section : sections) {
+        TimeSlot slot(0);
+        auto pin = findSectionRequirement(*section);
+        const auto& placed = placedByHandle[section->getHandle()];
+        bool changed = section->isSameAs(*changedSection);
+        
+        if (pin && pin->getTimeSlot().hasDay() && pin->getTimeSlot().hasStartTime()) {
+            slot = TimeSlot(section->getTimeSlot().getDurationMinutes(),
+                            pin->getTimeSlot().getDay(),
+                            pin->getTimeSlot().getStartHour(),
+                            pin->getTimeSlot().getStartMinute());
+        } else if (placed && !changed) {
+            slot = placed->getTimeSlot();
+        } else {
+            // New section: start from its own time if it has one, the repair moves it if needed
+            auto own = section->getTimeSlot();
+            slot = TimeSlot(own.getDurationMinutes(),
+                            own.hasDay() ? own.getDay() : TimeSlot::MONDAY,
+                            own.hasStartTime() ? own.getStartHour() : repairOptions.earliestStartMinutes / 60,
+                            own.hasStartTime() ? own.getStartMinute() : repairOptions.earliestStartMinutes % 60);
+        }
+        
+        if (changed) {
+            changedIndex = working.size();
+        }
+        working.push_back(section->withTimeSlot(slot));
+        pinned.push_back(pin != nullptr);
+    }
+    
+    if (changedIndex == working.size()) {
+        // The section is not part of this term
+        return generateSchedule(options);
+    }
+    
+    // The neighbourhood: the changed section and whatever it now overlaps
+    const TimeSlot& changedSlot = working[changedIndex]->getTimeSlot();
+    std::vector<bool> fixed(working.size(), true);
+    size_t neighbourhood = 0;
+    for (size_t i = 0; i < working.size(); i++) {
+        bool affected = i == changedIndex || working[i]->getTimeSlot().overlaps(changedSlot);
+        if (affected && !pinned[i]) {
+            fixed[i] = false;
+            neighbourhood++;
+        }
+    }
+    
+    MinConflictsRepair repair(working, fixed, repairOptions);
+    std::shared_ptr<Schedule> repaired;
+    {
+        PhaseTimer timer(solveContext.stats, SolvePhase::PACKING);
+        repaired = repair.run();
+    }
+    solveContext.progress.candidatesTried = repair.getStepsTaken();
+    if (!repaired) {
+        solveContext.stats.packingFailures++;
+        solveContext.stats.reject(RejectReason::UNREPAIRABLE_PACKING);
+        SLOG_INFO("incremental", "Re-solve failed around " << changedSection->getId()
+                 << ", falling back to a full solve");
+        return generateSchedule(options);
+    }
+    
+    SLOG_DEBUG("incremental", "Re-solve moved within " << neighbourhood << " sections in "
+              << repair.getStepsTaken() << " steps");
+    
+    // The repaired schedule replaces the previous results, as a solve would
+    possibleSchedules.clear();
+    retainedSchedules.clear();
+    currentSchedule = nullptr;
+    retainSchedule(repaired);
+    possibleSchedules = retainedSchedules.sorted();
+    retainedSchedules.clear();
+    bool found = findSatisfyingSchedule();
+    
+    if (options.cancel && options.cancel->load()) {
+        solveContext.status = SolveStatus::CANCELLED;
+    }
+    markSolved();
+    finishStats();
+    reportProgress(true);
+    return found;
 }
 
 std::shared_ptr<Schedule> Scheduler::getCurrentSchedule() const {
@@ -290,24 +1041,110 @@ std::vector<std::shared_ptr<Schedule>> Scheduler::getAllPossibleSchedules() cons
     return possibleSchedules;
 }
 
+void Scheduler::restoreSchedules(const std::vector<std::shared_ptr<Schedule>>& schedules, int currentIndex) {
+    possibleSchedules = schedules;
+    retainedSchedules.clear();
+    markSolved();
+    currentSchedule = currentIndex >= 0 && currentIndex < static_cast<int>(schedules.size())
+        ? schedules[currentIndex] : nullptr;
+}
+
+void Scheduler::setMaxRetainedSchedules(size_t maxSchedules) {
+    retainedSchedules.setCapacity(maxSchedules);
+}
+
+size_t Scheduler::getMaxRetainedSchedules() const {
+    return retainedSchedules.getCapacity();
+}
+
+void Scheduler::setScheduleScorer(TopKSchedules::ScoreFunction scorer) {
+    scheduleScorer = scorer;
+    scorerVersion++;
+}
+
+double Scheduler::scoreSchedule(const Schedule& schedule) const {
+    if (scheduleScorer) {
+        return scheduleScorer(schedule);
+    }
+    
+    // Default: hard requirements dominate, preferences break ties between them
+    double score = preferenceScorer.evaluate(schedule);
+    for (const auto& requirement : requirements) {
+        if (requirement->isSatisfied(schedule)) {
+            score += REQUIREMENT_SCORE;
+        }
+    }
+    return score;
+}
+
+// Helper method to offer a valid schedule to the retained set (skips duplicates)
+bool Scheduler::retainSchedule(std::shared_ptr<Schedule> schedule) {
+    solveContext.progress.validFound++;
+    SolverStats& stats = solveContext.stats;
+    double score;
+    {
+        PhaseTimer timer(stats, SolvePhase::SCORING);
+        score = scoreSchedule(*schedule);
+    }
+    
+    // Drop it right away if it cannot make the cut
+    if (!retainedSchedules.wouldRetain(score)) {
+        stats.reject(RejectReason::BELOW_CUTOFF);
+        return false;
+    }
+    
+    // Check if we already have an equivalent schedule
+    bool isDuplicate;
+    {
+        PhaseTimer timer(stats, SolvePhase::DEDUPE);
+        isDuplicate = retainedSchedules.anyOf([&](const Schedule& existing) {
+            return areSchedulesEquivalent(*schedule, existing);
+        });
+    }
+    if (isDuplicate) {
+        stats.dedupeHits++;
+        stats.reject(RejectReason::DUPLICATE);
+        return false;
+    }
+    
+    // Candidates live in the solve's arena, only what is kept moves to the pools
+    schedule = SolveArena::promote(*schedule);
+    if (!retainedSchedules.offer(schedule, score)) {
+        return false;
+    }
+    if (solveContext.options.onSchedule) {
+        solveContext.options.onSchedule(schedule);
+    }
+    return true;
+}
+
 void Scheduler::clear() {
     courses.clear();
     teachers.clear();
     sections.clear();
+    courseRegistry.clear();
+    teacherRegistry.clear();
+    sectionRegistry.clear();
     requirements.clear();
+    requirementSet.clear();
+    pinsStale = true;
+    preferences.clear();
+    preferenceScorer = PreferenceScorer();
     possibleSchedules.clear();
+    retainedSchedules.clear();
     currentSchedule = nullptr;
+    notifyChange(ModelChange::CLEAR);
 }
 
-const std::vector<std::shared_ptr<Course>>& Scheduler::getCourses() const {
+const std::vector<Ref<Course>>& Scheduler::getCourses() const {
     return courses;
 }
 
-const std::vector<std::shared_ptr<Teacher>>& Scheduler::getTeachers() const {
+const std::vector<Ref<Teacher>>& Scheduler::getTeachers() const {
     return teachers;
 }
 
-const std::vector<std::shared_ptr<Section>>& Scheduler::getSections() const {
+const std::vector<Ref<Section>>& Scheduler::getSections() const {
     return sections;
 }
 
@@ -315,6 +1152,30 @@ const std::vector<std::shared_ptr<Requirement>>& Scheduler::getRequirements() co
     return requirements;
 }
 
+Ref<Course> Scheduler::findCourse(std::string_view code) const {
+    return courseRegistry.find(code);
+}
+
+Ref<Teacher> Scheduler::findTeacher(std::string_view id) const {
+    return teacherRegistry.find(id);
+}
+
+Ref<Section> Scheduler::findSection(std::string_view id) const {
+    return sectionRegistry.find(id);
+}
+
+const EntityRegistry<Course>& Scheduler::getCourseRegistry() const {
+    return courseRegistry;
+}
+
+const EntityRegistry<Teacher>& Scheduler::getTeacherRegistry() const {
+    return teacherRegistry;
+}
+
+const EntityRegistry<Section>& Scheduler::getSectionRegistry() const {
+    return sectionRegistry;
+}
+
 // Helper method to find a schedule that satisfies all requirements
 bool Scheduler::findSatisfyingSchedule() {
     // If no schedules were generated, return false
@@ -322,7 +1183,10 @@ bool Scheduler::findSatisfyingSchedule() {
         return false;
     }
     
-    // Try to find a schedule that satisfies all requirements
+    SolverStats& stats = solveContext.stats;
+    PhaseTimer timer(stats, SolvePhase::REQUIREMENT_CHECK);
+    
+    // Schedules are ordered best first, so the top one usually satisfies everything
     for (const auto& schedule : possibleSchedules) {
         bool satisfiesAll = true;
         
@@ -337,6 +1201,8 @@ bool Scheduler::findSatisfyingSchedule() {
             currentSchedule = schedule;
             return true;
         }
+        stats.requirementFailures++;
+        stats.reject(RejectReason::REQUIREMENT_UNSATISFIED);
     }
     
     // If no schedule satisfies all requirements, just pick the first one
@@ -353,9 +1219,9 @@ PQTree Scheduler::buildSchedulePQTree() const {
     
     if (currentSchedule) {
         // Group sections by day
-        std::map<TimeSlot::Day, std::vector<std::shared_ptr<Section>>> sectionsByDay;
+        std::map<TimeSlot::Day, std::vector<Ref<Section>>> sectionsByDay;
         for (const auto& section : currentSchedule->getSections()) {
-            sectionsByDay[section->getTimeSlot()->getDay()].push_back(section);
+            sectionsByDay[section->getTimeSlot().getDay()].push_back(section);
         }
         
         // Create root P-node
@@ -382,14 +1248,14 @@ PQTree Scheduler::buildSchedulePQTree() const {
                 rootNode->addChild(dayNode);
                 
                 // Sort sections by time
-                std::vector<std::shared_ptr<Section>> sortedSections = sections;
+                std::vector<Ref<Section>> sortedSections = sections;
                 std::sort(sortedSections.begin(), sortedSections.end(),
-                    [](const std::shared_ptr<Section>& a, const std::shared_ptr<Section>& b) {
+                    [](const Ref<Section>& a, const Ref<Section>& b) {
                         // Only sort by time if both have start times
-                        if (a->getTimeSlot()->hasStartTime() && b->getTimeSlot()->hasStartTime()) {
-                            return a->getTimeSlot()->getStartHour() < b->getTimeSlot()->getStartHour() ||
-                                   (a->getTimeSlot()->getStartHour() == b->getTimeSlot()->getStartHour() &&
-                                    a->getTimeSlot()->getStartMinute() < b->getTimeSlot()->getStartMinute());
+                        if (a->getTimeSlot().hasStartTime() && b->getTimeSlot().hasStartTime()) {
+                            return a->getTimeSlot().getStartHour() < b->getTimeSlot().getStartHour() ||
+                                   (a->getTimeSlot().getStartHour() == b->getTimeSlot().getStartHour() &&
+                                    a->getTimeSlot().getStartMinute() < b->getTimeSlot().getStartMinute());
                         }
                         return false;
                     });
@@ -399,7 +1265,7 @@ PQTree Scheduler::buildSchedulePQTree() const {
                     // Format the label similar to the sample code
                     std::string label = section->getCourse()->getCode() + " (" + 
                                         section->getTeacher()->getName() + ", " +
-                                        section->getTimeSlot()->toString() + ")";
+                                        section->getTimeSlot().toString() + ")";
                     
                     auto leaf = tree.createLeaf(label);
                     dayNode->addChild(leaf);
@@ -423,9 +1289,9 @@ PQTree Scheduler::buildSchedulePQTreeForIndex(int scheduleIndex) const {
         auto schedule = possibleSchedules[scheduleIndex];
         
         // Group sections by day
-        std::map<TimeSlot::Day, std::vector<std::shared_ptr<Section>>> sectionsByDay;
+        std::map<TimeSlot::Day, std::vector<Ref<Section>>> sectionsByDay;
         for (const auto& section : schedule->getSections()) {
-            sectionsByDay[section->getTimeSlot()->getDay()].push_back(section);
+            sectionsByDay[section->getTimeSlot().getDay()].push_back(section);
         }
         
         // Create root P-node
@@ -452,14 +1318,14 @@ PQTree Scheduler::buildSchedulePQTreeForIndex(int scheduleIndex) const {
                 rootNode->addChild(dayNode);
                 
                 // Sort sections by time
-                std::vector<std::shared_ptr<Section>> sortedSections = sections;
+                std::vector<Ref<Section>> sortedSections = sections;
                 std::sort(sortedSections.begin(), sortedSections.end(),
-                    [](const std::shared_ptr<Section>& a, const std::shared_ptr<Section>& b) {
+                    [](const Ref<Section>& a, const Ref<Section>& b) {
                         // Only sort by time if both have start times
-                        if (a->getTimeSlot()->hasStartTime() && b->getTimeSlot()->hasStartTime()) {
-                            return a->getTimeSlot()->getStartHour() < b->getTimeSlot()->getStartHour() ||
-                                   (a->getTimeSlot()->getStartHour() == b->getTimeSlot()->getStartHour() &&
-                                    a->getTimeSlot()->getStartMinute() < b->getTimeSlot()->getStartMinute());
+                        if (a->getTimeSlot().hasStartTime() && b->getTimeSlot().hasStartTime()) {
+                            return a->getTimeSlot().getStartHour() < b->getTimeSlot().getStartHour() ||
+                                   (a->getTimeSlot().getStartHour() == b->getTimeSlot().getStartHour() &&
+                                    a->getTimeSlot().getStartMinute() < b->getTimeSlot().getStartMinute());
                         }
                         return false;
                     });
@@ -469,7 +1335,7 @@ PQTree Scheduler::buildSchedulePQTreeForIndex(int scheduleIndex) const {
                     // Format the label similar to the sample code
                     std::string label = section->getCourse()->getCode() + " (" + 
                                         section->getTeacher()->getName() + ", " +
-                                        section->getTimeSlot()->toString() + ")";
+                                        section->getTimeSlot().toString() + ")";
                     
                     auto leaf = tree.createLeaf(label);
                     dayNode->addChild(leaf);
@@ -495,25 +1361,21 @@ bool Scheduler::areSchedulesEquivalent(const Schedule& a, const Schedule& b) con
     for (const auto& sectionA : a.getSections()) {
         bool foundMatch = false;
         
-        for (const auto& sectionB : b.getSections()) {
-            // Check that the section has the same course
-            if (sectionA->getCourse()->getCode() != sectionB->getCourse()->getCode()) {
-                continue;
-            }
-            
+        // Only sections of the same course can match
+        for (const auto& sectionB : b.getSectionsForCourse(*sectionA->getCourse())) {
             // Check that the section has the same teacher
-            if (sectionA->getTeacher()->getId() != sectionB->getTeacher()->getId()) {
+            if (!sectionA->getTeacher()->isSameAs(*sectionB->getTeacher())) {
                 continue;
             }
             
             // Check that the section has the same day
-            if (sectionA->getTimeSlot()->getDay() != sectionB->getTimeSlot()->getDay()) {
+            if (sectionA->getTimeSlot().getDay() != sectionB->getTimeSlot().getDay()) {
                 continue;
             }
             
             // Check that the section has the same start time
-            if (sectionA->getTimeSlot()->getStartHour() != sectionB->getTimeSlot()->getStartHour() ||
-                sectionA->getTimeSlot()->getStartMinute() != sectionB->getTimeSlot()->getStartMinute()) {
+            if (sectionA->getTimeSlot().getStartHour() != sectionB->getTimeSlot().getStartHour() ||
+                sectionA->getTimeSlot().getStartMinute() != sectionB->getTimeSlot().getStartMinute()) {
                 continue;
             }
             
@@ -532,9 +1394,10 @@ bool Scheduler::areSchedulesEquivalent(const Schedule& a, const Schedule& b) con
     return true;
 }
 
-bool Scheduler::scheduleSections(std::shared_ptr<PQNode> permutationTree) {
+bool Scheduler::scheduleSections(Ref<PQNode> permutationTree) {
     // Clear any existing schedules
     possibleSchedules.clear();
+    retainedSchedules.clear();
     
     // Create a PQ tree and set the provided node as root
     PQTree tree;
@@ -544,7 +1407,7 @@ bool Scheduler::scheduleSections(std::shared_ptr<PQNode> permutationTree) {
     std::vector<std::vector<int>> permutations;
     tree.getAllPermutations(permutations);
     
-    std::cout << "Found " << permutations.size() << " possible permutations" << std::endl;
+    SLOG_DEBUG("solver", "Found " << permutations.size() << " possible permutations");
     
     // Try to create a schedule for each permutation
     for (const auto& permutation : permutations) {
@@ -553,79 +1416,66 @@ bool Scheduler::scheduleSections(std::shared_ptr<PQNode> permutationTree) {
         
         // Check if a valid schedule was created
         if (!schedule.hasConflicts() && schedule.getSections().size() > 0) {
-            // Check if we already have an equivalent schedule
-            bool isDuplicate = false;
-            for (const auto& existingSchedule : possibleSchedules) {
-                if (areSchedulesEquivalent(schedule, *existingSchedule)) {
-                    isDuplicate = true;
-                    break;
-                }
-            }
-            
-            // Only add if it's not a duplicate
-            if (!isDuplicate) {
-                possibleSchedules.push_back(std::make_shared<Schedule>(schedule));
-            }
+            retainSchedule(std::make_shared<Schedule>(schedule));
         }
     }
     
+    possibleSchedules = retainedSchedules.sorted();
+    retainedSchedules.clear();
+    
     // Return true if at least one valid schedule was found
     return !possibleSchedules.empty();
 }
 
 // New helper method to create variations of schedules
-void Scheduler::createScheduleVariations(const Schedule& baseSchedule) {
+void Scheduler::createScheduleVariations(std::shared_ptr<const Schedule> baseSchedule) {
     // Get all sections from the base schedule
-    auto baseSections = baseSchedule.getSections();
+    const auto& baseSections = baseSchedule->getSections();
     
-    // Identify sections without specific requirements
-    std::vector<std::shared_ptr<Section>> sectionsWithoutRequirements;
+    // Identify positions of sections without specific requirements
+    std::vector<size_t> flexibleIndices;
     
-    for (const auto& section : baseSections) {
-        bool hasSpecificRequirement = false;
-        
-        for (const auto& req : requirements) {
-            auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(req);
-            if (sectionReq && sectionReq->getSection()->getId() == section->getId()) {
-                hasSpecificRequirement = true;
-                break;
-            }
-        }
-        
-        if (!hasSpecificRequirement) {
-            sectionsWithoutRequirements.push_back(section);
+    for (size_t i = 0; i < baseSections.size(); i++) {
+        if (!findSectionRequirement(*baseSections[i])) {
+            flexibleIndices.push_back(i);
         }
     }
     
     // If no sections without requirements, nothing to vary
-    if (sectionsWithoutRequirements.empty()) {
+    if (flexibleIndices.empty()) {
         return;
     }
     
     // Create variations for each section without requirements
-    for (const auto& flexibleSection : sectionsWithoutRequirements) {
+    for (size_t flexibleIndex : flexibleIndices) {
+        const auto& flexibleSection = baseSections[flexibleIndex];
+        
         // Get current day and time
         auto currentTimeSlot = flexibleSection->getTimeSlot();
-        TimeSlot::Day currentDay = currentTimeSlot->getDay();
-        int currentStartHour = currentTimeSlot->getStartHour();
-        int currentStartMinute = currentTimeSlot->getStartMinute();
-        int duration = currentTimeSlot->getDurationMinutes();
+        TimeSlot::Day currentDay = currentTimeSlot.getDay();
+        int currentStartHour = currentTimeSlot.getStartHour();
+        int currentStartMinute = currentTimeSlot.getStartMinute();
+        int duration = currentTimeSlot.getDurationMinutes();
         
         // Create 3 variations with different days/times
         for (int variant = 1; variant <= 3; variant++) {
-            // Create a copy of the base schedule
-            Schedule newSchedule = baseSchedule;
+            if (shouldStop()) {
+                return;
+            }
+            solveContext.progress.candidatesTried++;
+            
+            // Each variation shares the base schedule and only records the moved section
+            ScheduleDelta newSchedule(baseSchedule);
             
             // Define new day and time - cycle through days
-            TimeSlot::Day newDay;
-            int newStartHour, newStartMinute;
+            TimeSlot::Day newDay = currentDay;
+            int newStartHour = currentStartHour;
+            int newStartMinute = currentStartMinute;
             
             switch (variant) {
                 case 1:
                     // Move to next day, same time
                     newDay = static_cast<TimeSlot::Day>((static_cast<int>(currentDay) + 1) % 5);
-                    newStartHour = currentStartHour;
-                    newStartMinute = currentStartMinute;
                     break;
                     
                 case 2:
@@ -644,7 +1494,7 @@ void Scheduler::createScheduleVariations(const Schedule& baseSchedule) {
             }
             
             // Create a new TimeSlot with the new day and time
-            auto newTimeSlot = std::make_shared<TimeSlot>(
+            TimeSlot newTimeSlot(
                 duration,
                 newDay,
                 newStartHour,
@@ -652,38 +1502,20 @@ void Scheduler::createScheduleVariations(const Schedule& baseSchedule) {
             );
             
             // Create a new Section with the new TimeSlot
-            auto newSection = std::make_shared<Section>(
-                flexibleSection->getId(),
-                flexibleSection->getCourse(),
-                flexibleSection->getTeacher(),
-                newTimeSlot
-            );
+            newSchedule.moveSection(flexibleIndex, arena.place(*flexibleSection, newTimeSlot));
             
-            // Find the section to replace in the new schedule
-            for (size_t i = 0; i < newSchedule.getSections().size(); i++) {
-                if (newSchedule.getSections()[i]->getId() == flexibleSection->getId()) {
-                    // Replace the section with the new one
-                    newSchedule.removeSection(newSchedule.getSections()[i]);
-                    newSchedule.addSection(newSection);
-                    break;
-                }
+            // Only the moved section needs to be checked against the rest
+            bool conflicted;
+            {
+                PhaseTimer timer(solveContext.stats, SolvePhase::CONFLICT_CHECK);
+                conflicted = newSchedule.hasConflicts();
             }
-            
-            // Check if the new schedule has conflicts
-            if (!newSchedule.hasConflicts()) {
-                // Check if this is a duplicate of an existing schedule
-                bool isDuplicate = false;
-                for (const auto& existingSchedule : possibleSchedules) {
-                    if (areSchedulesEquivalent(newSchedule, *existingSchedule)) {
-                        isDuplicate = true;
-                        break;
-                    }
-                }
-                
-                // Only add if not a duplicate
-                if (!isDuplicate) {
-                    possibleSchedules.push_back(std::make_shared<Schedule>(newSchedule));
-                }
+            if (!conflicted) {
+                // Materialize the variation only once it is known to be valid
+                retainSchedule(newSchedule.flatten());
+            } else {
+                solveContext.stats.conflictRejects++;
+                solveContext.stats.reject(RejectReason::VARIATION_CONFLICT);
             }
         }
     }
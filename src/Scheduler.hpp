@@ -3,18 +3,109 @@
 
 #include "PQTree.hpp"
 #include "Models.hpp"
+#include "ScheduleRetention.hpp"
+#include "Preferences.hpp"
+#include "LocalSearch.hpp"
+#include "SatEncoder.hpp"
+#include "SolveCache.hpp"
+#include "SolverStats.hpp"
+#include "EntityRegistry.hpp"
+#include "SolveArena.hpp"
 #include <vector>
 #include <memory>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+
+enum class SolverMode {
+    ENUMERATE,     // PQ-tree permutations plus variations (default)
+    LOCAL_SEARCH,  // Simulated annealing from the greedy packing
+    SAT            // CNF encoding solved by the embedded CDCL solver
+};
+
+enum class SolveStatus {
+    COMPLETED,     // The solver ran to the end
+    TIMED_OUT,     // The wall-clock budget ran out
+    CANCELLED,     // The cancellation token was set
+    LIMIT_REACHED  // maxSchedules valid schedules were found
+};
+
+struct SolveProgress {
+    long candidatesTried = 0;
+    long candidatesTotal = 0;  // Upper bound on candidates (0 = unknown)
+    long validFound = 0;
+    bool hasBest = false;
+    double bestScore = 0.0;
+    long elapsedMs = 0;
+};
+
+// Limits and hooks for a single solve. The defaults reproduce the old blocking behaviour.
+struct SolveOptions {
+    SolverMode mode = SolverMode::ENUMERATE;
+    int timeBudgetMs = -1;          // Wall-clock budget (-1 = unlimited)
+    long maxSchedules = -1;         // Stop after this many valid schedules (-1 = unlimited)
+    size_t memoryBudgetBytes = 0;   // Caps how many schedules are retained (0 = unlimited)
+    
+    // Called from the solving thread at most every progressIntervalMs, and once at the end
+    std::function<void(const SolveProgress&)> onProgress;
+    int progressIntervalMs = 100;
+    
+    // Called from the solving thread whenever a schedule enters the retained set. It may
+    // still be pushed out by a better one; the final ranking is getAllPossibleSchedules().
+    std::function<void(std::shared_ptr<Schedule>)> onSchedule;
+    
+    // Set to true from any thread to stop the solve; the best result so far is kept
+    std::shared_ptr<std::atomic<bool>> cancel;
+    
+    // Mode specific settings (their time budgets are capped by timeBudgetMs)
+    LocalSearchOptions localSearch;
+    SatScheduleOptions sat;
+};
+
+// One change to the scheduler's inputs, as reported to the change listener.
+// Only the members relevant to the kind are set.
+struct ModelChange {
+    enum Kind {
+        ADD_COURSE, REMOVE_COURSE,
+        ADD_TEACHER, REMOVE_TEACHER, ASSIGN_COURSE,
+        ADD_SECTION, REMOVE_SECTION,
+        ADD_REQUIREMENT, REMOVE_REQUIREMENT,
+        ADD_PREFERENCE, REMOVE_PREFERENCE,
+        CLEAR
+    };
+    
+    Kind kind;
+    Ref<Course> course;
+    Ref<Teacher> teacher;
+    Ref<Section> section;
+    std::shared_ptr<Requirement> requirement;
+    const StudentPreference* preference = nullptr;
+    size_t index = 0;  // Position of a removed requirement or preference
+};
 
 class Scheduler {
 public:
     Scheduler();
     
-    // Add data to the scheduler
-    void addCourse(std::shared_ptr<Course> course);
-    void addTeacher(std::shared_ptr<Teacher> teacher);
-    void addSection(std::shared_ptr<Section> section);
+    // Add data to the scheduler; false if it is already held or its code/id is taken
+    bool addCourse(Ref<Course> course);
+    bool addTeacher(Ref<Teacher> teacher);
+    bool addSection(Ref<Section> section);
+    
+    // Lets a teacher teach a course without giving them a section yet
+    void assignCourse(Ref<Teacher> teacher, Ref<Course> course);
+    
+    // Removing a course or teacher also removes its sections; requirements that
+    // mention anything removed are dropped with it
+    void removeCourse(Ref<Course> course);
+    void removeTeacher(Ref<Teacher> teacher);
+    void removeSection(Ref<Section> section);
+    
+    // Room for this many more of each before a bulk load
+    void reserve(size_t moreCourses, size_t moreTeachers, size_t moreSections);
     
     // Add requirements/constraints
     void addRequirement(std::shared_ptr<Requirement> requirement);
@@ -22,11 +113,68 @@ public:
     // Remove a requirement
     void removeRequirement(std::shared_ptr<Requirement> requirement);
     
+    // Soft constraints that rank schedules without rejecting them
+    void addPreference(const StudentPreference& preference);
+    void removePreference(size_t index);
+    const std::vector<StudentPreference>& getPreferences() const;
+    const PreferenceScorer& getPreferenceScorer() const;
+    
     // Generate and get schedules
     bool generateSchedule();
+    
+    // Generate with a budget, progress reporting and cancellation
+    bool generateSchedule(const SolveOptions& options);
+    SolveStatus getLastSolveStatus() const;
+    const SolveProgress& getLastSolveProgress() const;
+    
+    // Phase timings, counters and rejection reasons of the last solve
+    const SolverStats& getLastSolverStats() const;
+    
+    // Improve the greedy packing with simulated annealing for large terms
+    bool generateScheduleLocalSearch(const LocalSearchOptions& options = LocalSearchOptions());
+    
+    // Encode the term as CNF and solve it with the embedded CDCL solver (tightly constrained terms)
+    bool generateScheduleSAT(const SatScheduleOptions& options = SatScheduleOptions());
+    
+    // Re-solve after adding one section or pinning one section: only the changed section and
+    // the sections it now collides with may move, the rest of the current schedule stays put.
+    // Falls back to a full solve with `options` when that neighbourhood cannot be repaired.
+    bool resolveIncrementally(Ref<Section> changedSection, const SolveOptions& options = SolveOptions(),
+                              const RepairOptions& repair = RepairOptions());
+    
+    // Re-solve after editing: repairs around the section when the only edits since the
+    // current schedule added or pinned that one section, solves from scratch otherwise
+    bool resolveAfterEdits(const SolveOptions& options = SolveOptions());
+    
+    // The section resolveAfterEdits would repair around (nullptr = full solve)
+    Ref<Section> getRepairableEdit() const;
+    
     std::shared_ptr<Schedule> getCurrentSchedule() const;
     std::vector<std::shared_ptr<Schedule>> getAllPossibleSchedules() const;
     
+    // Installs previously generated schedules (best first), e.g. from a snapshot
+    void restoreSchedules(const std::vector<std::shared_ptr<Schedule>>& schedules, int currentIndex);
+    
+    // Only the best N schedules are kept while generating (default 100)
+    void setMaxRetainedSchedules(size_t maxSchedules);
+    size_t getMaxRetainedSchedules() const;
+    
+    // Solves with an unchanged input fingerprint are answered from an LRU cache
+    // (capacity 0 disables it, a directory also keeps results on disk)
+    void setSolveCacheCapacity(size_t entries);
+    void setSolveCacheDirectory(const std::string& directory);
+    uint64_t computeFingerprint(const SolveOptions& options) const;
+    
+    // Score used to rank schedules (higher is better). By default every satisfied
+    // requirement is worth REQUIREMENT_SCORE, plus the weighted preference score.
+    void setScheduleScorer(TopKSchedules::ScoreFunction scorer);
+    double scoreSchedule(const Schedule& schedule) const;
+    
+    // Check if two schedules are equivalent (same course, teacher, day and start per section)
+    bool areSchedulesEquivalent(const Schedule& a, const Schedule& b) const;
+    
+    static constexpr double REQUIREMENT_SCORE = 1000.0;
+    
     // Build a PQ tree for the current schedule (for visualization)
     PQTree buildSchedulePQTree() const;
     
@@ -36,44 +184,135 @@ public:
     // Clear all data
     void clear();
     
+    // Called after every change made through the methods above (not for reserve
+    // or the solver's output); pass nullptr to stop listening
+    using ChangeListener = std::function<void(const ModelChange&)>;
+    void setChangeListener(ChangeListener listener);
+    
     // Get data
-    const std::vector<std::shared_ptr<Course>>& getCourses() const;
-    const std::vector<std::shared_ptr<Teacher>>& getTeachers() const;
-    const std::vector<std::shared_ptr<Section>>& getSections() const;
+    const std::vector<Ref<Course>>& getCourses() const;
+    const std::vector<Ref<Teacher>>& getTeachers() const;
+    const std::vector<Ref<Section>>& getSections() const;
     const std::vector<std::shared_ptr<Requirement>>& getRequirements() const;
     
+    // O(1) lookups by code or id; nullptr if nothing held has it
+    Ref<Course> findCourse(std::string_view code) const;
+    Ref<Teacher> findTeacher(std::string_view id) const;
+    Ref<Section> findSection(std::string_view id) const;
+    
+    // Handles of the held entities, for tables indexed by handle
+    const EntityRegistry<Course>& getCourseRegistry() const;
+    const EntityRegistry<Teacher>& getTeacherRegistry() const;
+    const EntityRegistry<Section>& getSectionRegistry() const;
+    
 private:
-    std::vector<std::shared_ptr<Course>> courses;
-    std::vector<std::shared_ptr<Teacher>> teachers;
-    std::vector<std::shared_ptr<Section>> sections;
+    std::vector<Ref<Course>> courses;
+    std::vector<Ref<Teacher>> teachers;
+    std::vector<Ref<Section>> sections;
     std::vector<std::shared_ptr<Requirement>> requirements;
+    std::vector<StudentPreference> preferences;
+    
+    // Handles and key lookup for the vectors above, so adding skips duplicates in O(1)
+    EntityRegistry<Course> courseRegistry;
+    EntityRegistry<Teacher> teacherRegistry;
+    EntityRegistry<Section> sectionRegistry;
+    std::unordered_set<const Requirement*> requirementSet;
+    
+    // The pin of each section, indexed by section handle; rebuilt after requirements change
+    mutable std::vector<std::shared_ptr<SectionTimeSlotRequirement>> pinsByHandle;
+    mutable bool pinsStale = true;
+    PreferenceScorer preferenceScorer;
+    ChangeListener changeListener;
     
     // The current generated schedule
     std::shared_ptr<Schedule> currentSchedule;
     
-    // All possible schedules generated
+    // All possible schedules generated (best first)
     std::vector<std::shared_ptr<Schedule>> possibleSchedules;
     
+    // Bounded set of the best schedules found during the current generation
+    TopKSchedules retainedSchedules;
+    TopKSchedules::ScoreFunction scheduleScorer;
+    int scorerVersion;  // Bumped by setScheduleScorer, custom scorers cannot be hashed
+    
+    SolveCache solveCache;
+    
+    // State of the solve in progress (limits, counters, status)
+    struct SolveContext {
+        SolveOptions options;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point lastProgress;
+        SolveProgress progress;
+        SolveStatus status = SolveStatus::COMPLETED;
+        bool conclusive = true;  // Cleared by a solver whose answer another run could change
+        SolverStats stats;
+    };
+    SolveContext solveContext;
+    
+    // Candidate sections of the solve in progress; released after each permutation
+    // and when a solver returns
+    SolveArena arena;
+    
+    // Edits since the current schedule was made; editedSection is the section they all
+    // added or pinned, if they touched only one
+    size_t editsSinceSolve = 0;
+    Ref<Section> editedSection;
+    
+    // Helper method to count an edit, `section` when it added or pinned one
+    void noteEdit(const Ref<Section>& section);
+    void markSolved();
+    
+    // Helper method to report a change to the listener, if any
+    void notifyChange(ModelChange::Kind kind, Ref<Course> course = nullptr,
+                      Ref<Teacher> teacher = nullptr, Ref<Section> section = nullptr);
+    
+    // Helper method to drop a section and the requirements pinning it, without notifying
+    void eraseSection(const Ref<Section>& section);
+    
+    // Helper method to drop the requirements that mention a removed course, teacher or section
+    void eraseRequirementsMentioning(const Course* course, const Teacher* teacher, const Section* section);
+    
+    // Helper method to check the budget and cancellation token (also reports progress)
+    bool shouldStop();
+    void reportProgress(bool force);
+    long remainingBudgetMs() const;
+    
+    // Helper method to stamp the total time on the stats and log them
+    void finishStats();
+    
+    // Helper method to enumerate PQ-tree permutations and their variations
+    bool enumerateSchedules();
+    
+    // Rough number of bytes a retained schedule costs, and the arena at its peak
+    size_t estimateScheduleBytes() const;
+    size_t estimateArenaBytes() const;
+    
     // Helper method to find a schedule that satisfies all requirements
     bool findSatisfyingSchedule();
     
+    // Helper method to offer a valid schedule to the retained set (skips duplicates)
+    bool retainSchedule(std::shared_ptr<Schedule> schedule);
+    
     // Helper method to generate all combinations of sections (one per course)
     void generateCourseSelections(
-        const std::map<std::string, std::vector<std::shared_ptr<Section>>>& sectionsByCourse,
-        std::vector<std::shared_ptr<Section>> current,
-        std::vector<std::vector<std::shared_ptr<Section>>>& result);
+        const std::map<std::string, std::vector<Ref<Section>>>& sectionsByCourse,
+        std::vector<Ref<Section>> current,
+        std::vector<std::vector<Ref<Section>>>& result);
         
     // Helper method to schedule sections based on a PQ Tree
-    bool scheduleSections(std::shared_ptr<PQNode> permutationTree);
+    bool scheduleSections(Ref<PQNode> permutationTree);
         
+    // Helper method to greedily assign days and start times (may leave conflicts)
+    Schedule packSections(const std::vector<int>& permutation);
+    
     // Helper method to create a schedule with assigned start times
     Schedule tryCreateScheduleWithTimes(const std::vector<int>& permutation);
     
+    // Helper method to find the time slot requirement pinning a section (or a placed copy), if any
+    std::shared_ptr<SectionTimeSlotRequirement> findSectionRequirement(const Section& section) const;
+    
     // Helper method to create schedule variations for sections without requirements
-    void createScheduleVariations(const Schedule& baseSchedule);
-        
-    // Helper to check if two schedules are equivalent (have same sections)
-    bool areSchedulesEquivalent(const Schedule& a, const Schedule& b) const;
+    void createScheduleVariations(std::shared_ptr<const Schedule> baseSchedule);
 };
 
 #endif // SCHEDULER_HPP 
\ No newline at end of file
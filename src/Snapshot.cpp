@@ -0,0 +1,489 @@
+#include "Snapshot.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+using namespace snapshot;
+
+// The layout is the file format, so it must not depend on the compiler's padding
+static_assert(sizeof(StringRef) == 8, "snapshot layout");
+static_assert(sizeof(SlotRecord) == 8, "snapshot layout");
+static_assert(sizeof(CourseRecord) == 24, "snapshot layout");
+static_assert(sizeof(TeacherRecord) == 24, "snapshot layout");
+static_assert(sizeof(SectionRecord) == 24, "snapshot layout");
+static_assert(sizeof(RequirementRecord) == 24, "snapshot layout");
+static_assert(sizeof(PreferenceRecord) == 40, "snapshot layout");
+static_assert(sizeof(ScheduleRecord) == 8, "snapshot layout");
+static_assert(sizeof(PlacementRecord) == 12, "snapshot layout");
+static_assert(sizeof(Header) == 32 + 16 * TABLE_COUNT, "snapshot layout");
+
+namespace {
+
+size_t recordSize(Table which) {
+    switch (which) {
+        case STRINGS:         return 1;
+        case COURSES:         return sizeof(CourseRecord);
+        case TEACHERS:        return sizeof(TeacherRecord);
+        case TEACHER_COURSES: return sizeof(uint32_t);
+        case SECTIONS:        return sizeof(SectionRecord);
+        case REQUIREMENTS:    return sizeof(RequirementRecord);
+        case PREFERENCES:     return sizeof(PreferenceRecord);
+        case SCHEDULES:       return sizeof(ScheduleRecord);
+        case PLACEMENTS:      return sizeof(PlacementRecord);
+        default:              return 0;
+    }
+}
+
+SlotRecord slotRecord(const TimeSlot& slot) {
+    SlotRecord record;
+    record.durationMinutes = slot.getDurationMinutes();
+    record.day = static_cast<int8_t>(slot.getDay());
+    record.startHour = static_cast<int8_t>(slot.getStartHour());
+    record.startMinute = static_cast<int8_t>(slot.getStartMinute());
+    record.reserved = 0;
+    return record;
+}
+
+// Collects the tables in memory, then writes them after the header
+class Writer {
+public:
+    StringRef string(const std::string& text) {
+        StringRef ref = { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size()) };
+        strings.insert(strings.end(), text.begin(), text.end());
+        return ref;
+    }
+
+    template <typename T>
+    void append(Table which, const T& record) {
+        const char* bytes = reinterpret_cast<const char*>(&record);
+        tables[which].insert(tables[which].end(), bytes, bytes + sizeof(T));
+    }
+
+    uint32_t count(Table which) const {
+        return static_cast<uint32_t>(tables[which].size() / recordSize(which));
+    }
+
+    bool write(const std::string& path, int currentSchedule, uint32_t journalSequence, std::string& error) {
+        tables[STRINGS] = strings;
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.currentSchedule = currentSchedule;
+        header.journalSequence = journalSequence;
+
+        uint64_t offset = sizeof(Header);
+        for (int i = 0; i < TABLE_COUNT; i++) {
+            offset = (offset + 7) & ~uint64_t(7);
+            header.tables[i].offset = offset;
+            header.tables[i].count = tables[i].size() / recordSize(static_cast<Table>(i));
+            offset += tables[i].size();
+        }
+        header.fileSize = offset;
+
+        // Write to a temporary name first so a crash never leaves a torn snapshot behind
+        std::string temporary = path + ".tmp";
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            error = "cannot write " + temporary;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        static const char padding[8] = {};
+        uint64_t written = sizeof(Header);
+        for (int i = 0; i < TABLE_COUNT; i++) {
+            out.write(padding, static_cast<std::streamsize>(header.tables[i].offset - written));
+            out.write(tables[i].data(), static_cast<std::streamsize>(tables[i].size()));
+            written = header.tables[i].offset + tables[i].size();
+        }
+        out.close();
+        if (!out) {
+            error = "cannot write " + temporary;
+            std::remove(temporary.c_str());
+            return false;
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            error = "cannot replace " + path;
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<char> strings;
+    std::vector<char> tables[TABLE_COUNT];
+};
+
+} // namespace
+
+bool Snapshot::save(const std::string& path, const Scheduler& scheduler, std::string& error,
+                    uint32_t journalSequence) {
+    TRACE_SCOPE("Snapshot::save", "io");
+    Writer writer;
+    
+    // Record index of each held entity, by handle; NONE for anything the scheduler does not hold
+    const auto& courseRegistry = scheduler.getCourseRegistry();
+    const auto& teacherRegistry = scheduler.getTeacherRegistry();
+    const auto& sectionRegistry = scheduler.getSectionRegistry();
+    std::vector<uint32_t> courseIndex(courseRegistry.handleBound(), NONE);
+    std::vector<uint32_t> teacherIndex(teacherRegistry.handleBound(), NONE);
+    std::vector<uint32_t> sectionIndex(sectionRegistry.handleBound(), NONE);
+    auto courseOf = [&](const Course* course) {
+        return courseRegistry.contains(course) ? courseIndex[course->getHandle()] : NONE;
+    };
+    auto teacherOf = [&](const Teacher* teacher) {
+        return teacherRegistry.contains(teacher) ? teacherIndex[teacher->getHandle()] : NONE;
+    };
+    auto sectionOf = [&](const Section& section) {
+        // Scheduled sections are copies that carry the original's handle
+        EntityHandle handle = section.getHandle() != NO_HANDLE ? section.getHandle()
+                                                               : sectionRegistry.findHandle(section.getId());
+        return handle < sectionIndex.size() ? sectionIndex[handle] : NONE;
+    };
+
+    for (const auto& course : scheduler.getCourses()) {
+        courseIndex[course->getHandle()] = writer.count(COURSES);
+        CourseRecord record = { writer.string(course->getCode()), writer.string(course->getName()),
+                                course->getCredits(), 0 };
+        writer.append(COURSES, record);
+    }
+
+    for (const auto& teacher : scheduler.getTeachers()) {
+        teacherIndex[teacher->getHandle()] = writer.count(TEACHERS);
+        TeacherRecord record = { writer.string(teacher->getId()), writer.string(teacher->getName()),
+                                 writer.count(TEACHER_COURSES), 0 };
+        for (const auto& course : teacher->getCourses()) {
+            uint32_t index = courseOf(course.get());
+            if (index != NONE) {
+                writer.append(TEACHER_COURSES, index);
+                record.courseCount++;
+            }
+        }
+        writer.append(TEACHERS, record);
+    }
+
+    for (const auto& section : scheduler.getSections()) {
+        uint32_t course = courseOf(section->getCourse().get());
+        uint32_t teacher = teacherOf(section->getTeacher().get());
+        if (course == NONE || teacher == NONE) {
+            error = "section " + section->getId() + " refers to a course or teacher the scheduler does not hold";
+            return false;
+        }
+        sectionIndex[section->getHandle()] = writer.count(SECTIONS);
+        SectionRecord record = { writer.string(section->getId()), course, teacher,
+                                 slotRecord(section->getTimeSlot()) };
+        writer.append(SECTIONS, record);
+    }
+
+    for (const auto& requirement : scheduler.getRequirements()) {
+        RequirementRecord record = { 0, NONE, NONE, 0, SlotRecord() };
+        if (auto pin = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(requirement)) {
+            record.kind = RequirementRecord::SECTION_TIME_SLOT;
+            record.subject = sectionOf(*pin->getSection());
+            record.slot = slotRecord(pin->getTimeSlot());
+        } else if (auto time = std::dynamic_pointer_cast<TimeSlotRequirement>(requirement)) {
+            record.kind = RequirementRecord::TIME_SLOT;
+            record.subject = courseOf(time->getCourse().get());
+            record.slot = slotRecord(time->getTimeSlot());
+        } else if (auto teacher = std::dynamic_pointer_cast<TeacherRequirement>(requirement)) {
+            record.kind = RequirementRecord::TEACHER;
+            record.subject = courseOf(teacher->getCourse().get());
+            record.teacher = teacherOf(teacher->getTeacher().get());
+        }
+        if (record.subject == NONE || (record.kind == RequirementRecord::TEACHER && record.teacher == NONE)) {
+            SLOG_WARN("snapshot", "Not saving requirement: " << requirement->getDescription());
+            continue;
+        }
+        writer.append(REQUIREMENTS, record);
+    }
+
+    for (const auto& preference : scheduler.getPreferences()) {
+        PreferenceRecord record = { static_cast<uint32_t>(preference.type), static_cast<int32_t>(preference.day),
+                                    preference.startHour, preference.endHour,
+                                    writer.string(preference.courseCode), writer.string(preference.teacherId),
+                                    preference.weight };
+        writer.append(PREFERENCES, record);
+    }
+
+    auto schedules = scheduler.getAllPossibleSchedules();
+    int currentSchedule = -1;
+    for (size_t i = 0; i < schedules.size(); i++) {
+        if (schedules[i] == scheduler.getCurrentSchedule()) {
+            currentSchedule = static_cast<int>(i);
+        }
+        ScheduleRecord record = { writer.count(PLACEMENTS), 0 };
+        for (const auto& section : schedules[i]->getSections()) {
+            uint32_t index = sectionOf(*section);
+            if (index == NONE) {
+                error = "schedule " + std::to_string(i + 1) + " holds unknown section " + section->getId();
+                return false;
+            }
+            PlacementRecord placement = { index, slotRecord(section->getTimeSlot()) };
+            writer.append(PLACEMENTS, placement);
+            record.placementCount++;
+        }
+        writer.append(SCHEDULES, record);
+    }
+
+    return writer.write(path, currentSchedule, journalSequence, error);
+}
+
+bool Snapshot::open(const std::string& path, std::string& error) {
+    close();
+    if (!file.open(path, error)) {
+        return false;
+    }
+
+    auto fail = [&](const std::string& reason) {
+        error = path + ": " + reason;
+        close();
+        return false;
+    };
+    if (file.size() < sizeof(Header)) {
+        return fail("too short for a snapshot");
+    }
+    const Header* candidate = reinterpret_cast<const Header*>(file.data());
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail("not a scheduler snapshot");
+    }
+    if (candidate->byteOrder != BYTE_ORDER_MARK) {
+        return fail("written on a machine with a different byte order");
+    }
+    if (candidate->version != VERSION) {
+        return fail("snapshot version " + std::to_string(candidate->version) +
+                    " is not supported (expected " + std::to_string(VERSION) + ")");
+    }
+    if (candidate->fileSize != file.size()) {
+        return fail("truncated or padded snapshot");
+    }
+    for (int i = 0; i < TABLE_COUNT; i++) {
+        const TableRef& ref = candidate->tables[i];
+        size_t size = recordSize(static_cast<Table>(i));
+        if (ref.offset % 8 != 0 || ref.offset > file.size() || ref.count > (file.size() - ref.offset) / size) {
+            return fail("table " + std::to_string(i) + " lies outside the file");
+        }
+    }
+    header = candidate;
+
+    courses.assign(courseCount(), nullptr);
+    teachers.assign(teacherCount(), nullptr);
+    sections.assign(sectionCount(), nullptr);
+    requirements.assign(requirementCount(), nullptr);
+    schedules.assign(scheduleCount(), nullptr);
+    return true;
+}
+
+void Snapshot::close() {
+    header = nullptr;
+    courses.clear();
+    teachers.clear();
+    sections.clear();
+    requirements.clear();
+    schedules.clear();
+    file.close();
+}
+
+int Snapshot::currentScheduleIndex() const {
+    if (!header || header->currentSchedule < 0 || static_cast<size_t>(header->currentSchedule) >= scheduleCount()) {
+        return -1;
+    }
+    return header->currentSchedule;
+}
+
+std::string_view Snapshot::string(const StringRef& ref) const {
+    auto strings = table<char>(STRINGS);
+    if (ref.offset > strings.size() || ref.length > strings.size() - ref.offset) {
+        return std::string_view();
+    }
+    return std::string_view(strings.data + ref.offset, ref.length);
+}
+
+TimeSlot Snapshot::timeSlot(const SlotRecord& slot) const {
+    auto day = slot.day >= 0 && slot.day <= TimeSlot::UNASSIGNED ? static_cast<TimeSlot::Day>(slot.day)
+                                                                 : TimeSlot::UNASSIGNED;
+    return TimeSlot(slot.durationMinutes, day, slot.startHour, slot.startMinute);
+}
+
+std::string_view Snapshot::courseCode(size_t index) const {
+    auto records = table<CourseRecord>(COURSES);
+    return index < records.size() ? string(records[index].code) : std::string_view();
+}
+
+std::string_view Snapshot::teacherId(size_t index) const {
+    auto records = table<TeacherRecord>(TEACHERS);
+    return index < records.size() ? string(records[index].id) : std::string_view();
+}
+
+std::string_view Snapshot::sectionId(size_t index) const {
+    auto records = table<SectionRecord>(SECTIONS);
+    return index < records.size() ? string(records[index].id) : std::string_view();
+}
+
+Ref<Course> Snapshot::course(size_t index) {
+    if (index >= courses.size()) {
+        return nullptr;
+    }
+    if (!courses[index]) {
+        const CourseRecord& record = table<CourseRecord>(COURSES)[index];
+        courses[index] = makeRef<Course>(std::string(string(record.code)),
+                                                  std::string(string(record.name)), record.credits);
+    }
+    return courses[index];
+}
+
+Ref<Teacher> Snapshot::teacher(size_t index) {
+    if (index >= teachers.size()) {
+        return nullptr;
+    }
+    if (!teachers[index]) {
+        const TeacherRecord& record = table<TeacherRecord>(TEACHERS)[index];
+        auto created = makeRef<Teacher>(std::string(string(record.id)), std::string(string(record.name)));
+        auto links = table<uint32_t>(TEACHER_COURSES);
+        for (uint64_t i = record.firstCourse; i < uint64_t(record.firstCourse) + record.courseCount && i < links.size(); i++) {
+            if (auto taught = course(links[i])) {
+                created->addCourse(taught);
+            }
+        }
+        teachers[index] = created;
+    }
+    return teachers[index];
+}
+
+Ref<Section> Snapshot::section(size_t index) {
+    if (index >= sections.size()) {
+        return nullptr;
+    }
+    if (!sections[index]) {
+        const SectionRecord& record = table<SectionRecord>(SECTIONS)[index];
+        auto owner = course(record.course);
+        auto instructor = teacher(record.teacher);
+        if (!owner || !instructor) {
+            return nullptr;
+        }
+        sections[index] = makeRef<Section>(std::string(string(record.id)), owner, instructor,
+                                                    timeSlot(record.slot));
+    }
+    return sections[index];
+}
+
+std::shared_ptr<Requirement> Snapshot::requirement(size_t index) {
+    if (index >= requirements.size()) {
+        return nullptr;
+    }
+    if (!requirements[index]) {
+        const RequirementRecord& record = table<RequirementRecord>(REQUIREMENTS)[index];
+        if (record.kind == RequirementRecord::SECTION_TIME_SLOT) {
+            if (auto pinned = section(record.subject)) {
+                requirements[index] = std::make_shared<SectionTimeSlotRequirement>(pinned, timeSlot(record.slot));
+            }
+        } else if (record.kind == RequirementRecord::TIME_SLOT) {
+            if (auto required = course(record.subject)) {
+                requirements[index] = std::make_shared<TimeSlotRequirement>(required, timeSlot(record.slot));
+            }
+        } else if (record.kind == RequirementRecord::TEACHER) {
+            auto required = course(record.subject);
+            auto instructor = teacher(record.teacher);
+            if (required && instructor) {
+                requirements[index] = std::make_shared<TeacherRequirement>(required, instructor);
+            }
+        }
+    }
+    return requirements[index];
+}
+
+std::shared_ptr<Schedule> Snapshot::schedule(size_t index) {
+    if (index >= schedules.size()) {
+        return nullptr;
+    }
+    if (!schedules[index]) {
+        const ScheduleRecord& record = table<ScheduleRecord>(SCHEDULES)[index];
+        auto placements = table<PlacementRecord>(PLACEMENTS);
+        if (uint64_t(record.firstPlacement) + record.placementCount > placements.size()) {
+            return nullptr;
+        }
+        auto created = std::make_shared<Schedule>();
+        for (uint32_t i = 0; i < record.placementCount; i++) {
+            const PlacementRecord& placement = placements[record.firstPlacement + i];
+            auto base = section(placement.section);
+            if (!base) {
+                return nullptr;
+            }
+            created->addSection(base->withTimeSlot(timeSlot(placement.slot)));
+        }
+        schedules[index] = created;
+    }
+    return schedules[index];
+}
+
+bool Snapshot::preference(size_t index, StudentPreference& preference) const {
+    auto records = table<PreferenceRecord>(PREFERENCES);
+    if (index >= records.size() || records[index].type > StudentPreference::COMPACT_DAYS) {
+        return false;
+    }
+    const PreferenceRecord& record = records[index];
+    preference.type = static_cast<StudentPreference::Type>(record.type);
+    preference.weight = record.weight;
+    preference.courseCode = std::string(string(record.courseCode));
+    preference.teacherId = std::string(string(record.teacherId));
+    preference.day = record.day >= 0 && record.day <= TimeSlot::UNASSIGNED ? static_cast<TimeSlot::Day>(record.day)
+                                                                           : TimeSlot::UNASSIGNED;
+    preference.startHour = record.startHour;
+    preference.endHour = record.endHour;
+    return true;
+}
+
+bool Snapshot::restore(Scheduler& scheduler, std::string& error) {
+    TRACE_SCOPE("Snapshot::restore", "io");
+    if (!header) {
+        error = "no snapshot open";
+        return false;
+    }
+
+    scheduler.clear();
+    scheduler.reserve(courseCount(), teacherCount(), sectionCount());
+    for (size_t i = 0; i < courseCount(); i++) {
+        scheduler.addCourse(course(i));
+    }
+    for (size_t i = 0; i < teacherCount(); i++) {
+        scheduler.addTeacher(teacher(i));
+    }
+    for (size_t i = 0; i < sectionCount(); i++) {
+        auto restored = section(i);
+        if (!restored) {
+            error = "section " + std::string(sectionId(i)) + " refers to a missing course or teacher";
+            return false;
+        }
+        scheduler.addSection(restored);
+    }
+    for (size_t i = 0; i < requirementCount(); i++) {
+        if (auto restored = requirement(i)) {
+            scheduler.addRequirement(restored);
+        }
+    }
+    StudentPreference restoredPreference;
+    for (size_t i = 0; i < preferenceCount(); i++) {
+        if (preference(i, restoredPreference)) {
+            scheduler.addPreference(restoredPreference);
+        }
+    }
+
+    std::vector<std::shared_ptr<Schedule>> restoredSchedules;
+    for (size_t i = 0; i < scheduleCount(); i++) {
+        auto restored = schedule(i);
+        if (!restored) {
+            error = "schedule " + std::to_string(i + 1) + " refers to a missing section";
+            return false;
+        }
+        restoredSchedules.push_back(restored);
+    }
+    scheduler.restoreSchedules(restoredSchedules, currentScheduleIndex());
+
+    SLOG_INFO("snapshot", "Restored " << courseCount() << " courses, " << teacherCount() << " teachers, "
+              << sectionCount() << " sections and " << scheduleCount() << " schedules");
+    return true;
+}
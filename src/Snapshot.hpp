@@ -0,0 +1,187 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "Scheduler.hpp"
+#include "MappedFile.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// On-disk layout of a scheduler snapshot. Every record is fixed size and every
+// reference is a table index or a byte range in the string table, so a mapped
+// file can be read in place. Tables start on 8-byte boundaries.
+namespace snapshot {
+
+constexpr char MAGIC[8] = { 'S', 'C', 'H', 'S', 'N', 'A', 'P', '\0' };
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;  // Reads back differently on a foreign byte order
+constexpr uint32_t NONE = 0xFFFFFFFF;
+
+enum Table {
+    STRINGS,          // Raw bytes, not terminated
+    COURSES,          // CourseRecord
+    TEACHERS,         // TeacherRecord
+    TEACHER_COURSES,  // uint32_t course index, ranges owned by TeacherRecord
+    SECTIONS,         // SectionRecord
+    REQUIREMENTS,     // RequirementRecord
+    PREFERENCES,      // PreferenceRecord
+    SCHEDULES,        // ScheduleRecord, best first
+    PLACEMENTS,       // PlacementRecord, ranges owned by ScheduleRecord
+    TABLE_COUNT
+};
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SlotRecord {
+    int32_t durationMinutes;
+    int8_t day;
+    int8_t startHour;
+    int8_t startMinute;
+    int8_t reserved;
+};
+
+struct CourseRecord {
+    StringRef code;
+    StringRef name;
+    int32_t credits;
+    uint32_t reserved;
+};
+
+struct TeacherRecord {
+    StringRef id;
+    StringRef name;
+    uint32_t firstCourse;  // Into TEACHER_COURSES
+    uint32_t courseCount;
+};
+
+struct SectionRecord {
+    StringRef id;
+    uint32_t course;
+    uint32_t teacher;
+    SlotRecord slot;
+};
+
+struct RequirementRecord {
+    enum Kind : uint32_t { TIME_SLOT, TEACHER, SECTION_TIME_SLOT };
+    uint32_t kind;
+    uint32_t subject;  // Course, or section for SECTION_TIME_SLOT
+    uint32_t teacher;  // TEACHER only
+    uint32_t reserved;
+    SlotRecord slot;   // Not used by TEACHER
+};
+
+struct PreferenceRecord {
+    uint32_t type;
+    int32_t day;
+    int32_t startHour;
+    int32_t endHour;
+    StringRef courseCode;
+    StringRef teacherId;
+    double weight;
+};
+
+struct ScheduleRecord {
+    uint32_t firstPlacement;  // Into PLACEMENTS
+    uint32_t placementCount;
+};
+
+struct PlacementRecord {
+    uint32_t section;  // The scheduled copy of this section
+    SlotRecord slot;
+};
+
+struct TableRef {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    int32_t currentSchedule;   // Index into SCHEDULES, -1 for none
+    uint32_t journalSequence;  // Last edit journal record folded in (0 = none)
+    TableRef tables[TABLE_COUNT];
+};
+
+} // namespace snapshot
+
+// Versioned binary image of a scheduler: entities, requirements, preferences,
+// the retained schedules and which one is current. Opening only maps the file
+// and checks the header; records are read in place and the model objects are
+// built the first time something asks for them.
+class Snapshot {
+public:
+    static bool save(const std::string& path, const Scheduler& scheduler, std::string& error,
+                     uint32_t journalSequence = 0);
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    size_t courseCount() const { return table<snapshot::CourseRecord>(snapshot::COURSES).size(); }
+    size_t teacherCount() const { return table<snapshot::TeacherRecord>(snapshot::TEACHERS).size(); }
+    size_t sectionCount() const { return table<snapshot::SectionRecord>(snapshot::SECTIONS).size(); }
+    size_t requirementCount() const { return table<snapshot::RequirementRecord>(snapshot::REQUIREMENTS).size(); }
+    size_t preferenceCount() const { return table<snapshot::PreferenceRecord>(snapshot::PREFERENCES).size(); }
+    size_t scheduleCount() const { return table<snapshot::ScheduleRecord>(snapshot::SCHEDULES).size(); }
+    int currentScheduleIndex() const;
+    uint32_t journalSequence() const { return header ? header->journalSequence : 0; }
+
+    // Straight from the mapping, nothing is materialized
+    std::string_view courseCode(size_t index) const;
+    std::string_view teacherId(size_t index) const;
+    std::string_view sectionId(size_t index) const;
+
+    // Built on first use and shared afterwards; nullptr for a bad index or a
+    // record that references something outside the file
+    Ref<Course> course(size_t index);
+    Ref<Teacher> teacher(size_t index);
+    Ref<Section> section(size_t index);
+    std::shared_ptr<Requirement> requirement(size_t index);
+    std::shared_ptr<Schedule> schedule(size_t index);
+    bool preference(size_t index, StudentPreference& preference) const;
+
+    // Replaces the scheduler's contents with everything in the snapshot
+    bool restore(Scheduler& scheduler, std::string& error);
+
+private:
+    // View of a table as an array of T
+    template <typename T>
+    struct Span {
+        const T* data = nullptr;
+        size_t count = 0;
+        size_t size() const { return count; }
+        const T& operator[](size_t index) const { return data[index]; }
+    };
+
+    template <typename T>
+    Span<T> table(snapshot::Table which) const {
+        Span<T> span;
+        if (header) {
+            span.data = reinterpret_cast<const T*>(file.data() + header->tables[which].offset);
+            span.count = static_cast<size_t>(header->tables[which].count);
+        }
+        return span;
+    }
+
+    std::string_view string(const snapshot::StringRef& ref) const;
+    TimeSlot timeSlot(const snapshot::SlotRecord& slot) const;
+
+    MappedFile file;
+    const snapshot::Header* header = nullptr;
+
+    // Materialized objects, indexed like their tables
+    std::vector<Ref<Course>> courses;
+    std::vector<Ref<Teacher>> teachers;
+    std::vector<Ref<Section>> sections;
+    std::vector<std::shared_ptr<Requirement>> requirements;
+    std::vector<std::shared_ptr<Schedule>> schedules;
+};
+
+#endif // SNAPSHOT_HPP
@@ -0,0 +1,32 @@
+#include "SolveArena.hpp"
+
+SolveArena::SolveArena(size_t initialBytes)
+    : initial(initialBytes),
+      resource(initial.data(), initial.size()) {}
+
+Ref<Section> SolveArena::place(const Section& section, const TimeSlot& timeSlot) {
+    placed++;
+    auto copy = makeRefAt<Section>(resource.allocate(sizeof(Section), alignof(Section)), section);
+    copy->setTimeSlot(timeSlot);
+    return copy;
+}
+
+std::shared_ptr<Schedule> SolveArena::promote(const Schedule& schedule) {
+    // Sections already in the pools, and the chunks holding only those, stay shared
+    auto promoted = std::make_shared<Schedule>(schedule);
+    const SectionList& sections = schedule.getSections();
+    for (size_t i = 0; i < sections.size(); i++) {
+        if (!sections[i]->isPooled()) {
+            promoted->replaceSection(i, sections[i]->withTimeSlot(sections[i]->getTimeSlot()));
+        }
+    }
+    return promoted;
+}
+
+void SolveArena::release() {
+    resource.release();
+}
+
+size_t SolveArena::getPlacedCount() const {
+    return placed;
+}
@@ -0,0 +1,40 @@
+#ifndef SOLVE_ARENA_HPP
+#define SOLVE_ARENA_HPP
+
+#include "Models.hpp"
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+// Monotonic memory for the candidate sections of one solve. Placing a section
+// bumps a pointer, dropping it only runs the destructor, and release() hands
+// everything back at once while keeping the first buffer for the next solve.
+// Anything that outlives the solve must be promoted to the pools first. Not
+// thread safe: each solving thread needs its own arena.
+class SolveArena {
+public:
+    explicit SolveArena(size_t initialBytes = 64 * 1024);
+
+    SolveArena(const SolveArena&) = delete;
+    SolveArena& operator=(const SolveArena&) = delete;
+
+    // A copy of the section at the given time, living in the arena
+    Ref<Section> place(const Section& section, const TimeSlot& timeSlot);
+
+    // Copy of a schedule whose sections may live in the arena, with those moved to the pools
+    static std::shared_ptr<Schedule> promote(const Schedule& schedule);
+
+    // Frees every placed section; none may still be referenced
+    void release();
+
+    // Sections placed since the arena was made
+    size_t getPlacedCount() const;
+
+private:
+    std::vector<std::byte> initial;
+    std::pmr::monotonic_buffer_resource resource;
+    size_t placed = 0;
+};
+
+#endif // SOLVE_ARENA_HPP
@@ -0,0 +1,258 @@
+#include "SolveCache.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+
+// Fingerprint implementation
+Fingerprint::Fingerprint() : hash(1469598103934665603ULL) {}
+
+void Fingerprint::mix(const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+Fingerprint& Fingerprint::add(const std::string& value) {
+    mix(value.data(), value.size());
+    mix("\x1f", 1);
+    return *this;
+}
+
+Fingerprint& Fingerprint::add(long long value) {
+    // Fixed byte order keeps the hash stable across machines
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<unsigned char>((static_cast<unsigned long long>(value) >> (8 * i)) & 0xff);
+    }
+    mix(bytes, sizeof(bytes));
+    mix("\x1f", 1);
+    return *this;
+}
+
+Fingerprint& Fingerprint::add(double value) {
+    long long bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return add(bits);
+}
+
+uint64_t Fingerprint::value() const {
+    return hash;
+}
+
+std::string Fingerprint::toHex() const {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+// SolveCache implementation
+SolveCache::SolveCache(size_t capacity) : capacity(capacity) {}
+
+void SolveCache::setCapacity(size_t capacity) {
+    this->capacity = capacity;
+    while (entries.size() > capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+size_t SolveCache::getCapacity() const {
+    return capacity;
+}
+
+void SolveCache::setDirectory(const std::string& directory) {
+    this->directory = directory;
+}
+
+const std::string& SolveCache::getDirectory() const {
+    return directory;
+}
+
+bool SolveCache::lookup(uint64_t key, const SectionLookup& findSection, CachedSolve& result) {
+    if (capacity == 0) {
+        return false;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        if (!rebind(it->second->second, findSection)) {
+            entries.erase(it->second);
+            index.erase(it);
+            return false;
+        }
+        // Move to the front as the most recently used
+        entries.splice(entries.begin(), entries, it->second);
+        result = it->second->second;
+        return true;
+    }
+
+    if (!directory.empty() && readFromDisk(key, findSection, result)) {
+        insert(key, result);
+        return true;
+    }
+    return false;
+}
+
+void SolveCache::store(uint64_t key, const CachedSolve& result) {
+    if (capacity == 0) {
+        return;
+    }
+    insert(key, result);
+    if (!directory.empty()) {
+        writeToDisk(key, result);
+    }
+}
+
+void SolveCache::insert(uint64_t key, const CachedSolve& result) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.emplace_front(key, result);
+    index[key] = entries.begin();
+
+    // Evict the least recently used entries
+    while (entries.size() > capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+// Points the placed copies back at the scheduler's current sections. Schedules are
+// shared with whoever took them earlier, so one that changes is copied first.
+bool SolveCache::rebind(CachedSolve& solve, const SectionLookup& findSection) {
+    for (auto& schedule : solve.schedules) {
+        std::shared_ptr<Schedule> rebuilt;
+        const auto& sections = schedule->getSections();
+        for (size_t i = 0; i < sections.size(); i++) {
+            const auto& placed = sections[i];
+            auto section = findSection(placed->getId());
+            if (!section) {
+                return false;
+            }
+            if (section->getHandle() == placed->getHandle() && section->getCourse() == placed->getCourse() &&
+                section->getTeacher() == placed->getTeacher()) {
+                continue;
+            }
+            if (!rebuilt) {
+                rebuilt = std::make_shared<Schedule>(*schedule);
+            }
+            rebuilt->replaceSection(i, section->withTimeSlot(placed->getTimeSlot()));
+        }
+        if (rebuilt) {
+            schedule = rebuilt;
+        }
+    }
+    return true;
+}
+
+size_t SolveCache::size() const {
+    return entries.size();
+}
+
+void SolveCache::clear() {
+    entries.clear();
+    index.clear();
+}
+
+std::string SolveCache::pathFor(uint64_t key) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.solve", static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+// File layout (text):
+//   SOLVE 1
+//   <found> <currentIndex> <scheduleCount>
+//   then per schedule: <sectionCount>, followed by one line per section
+//   <day> <startHour> <startMinute> <duration> <sectionId>
+bool SolveCache::readFromDisk(uint64_t key, const SectionLookup& findSection, CachedSolve& result) const {
+    std::ifstream file(pathFor(key));
+    if (!file) {
+        return false;
+    }
+
+    std::string magic;
+    int version = 0;
+    file >> magic >> version;
+    if (magic != "SOLVE" || version != 1) {
+        return false;
+    }
+
+    int found = 0;
+    size_t scheduleCount = 0;
+    CachedSolve loaded;
+    file >> found >> loaded.currentIndex >> scheduleCount;
+    loaded.found = found != 0;
+
+    for (size_t s = 0; s < scheduleCount && file; s++) {
+        size_t sectionCount = 0;
+        file >> sectionCount;
+
+        auto schedule = std::make_shared<Schedule>();
+        for (size_t i = 0; i < sectionCount; i++) {
+            int day = 0, startHour = 0, startMinute = 0, duration = 0;
+            std::string sectionId;
+            file >> day >> startHour >> startMinute >> duration;
+            file.ignore(1);
+            std::getline(file, sectionId);
+            if (!file) {
+                return false;
+            }
+
+            // The inputs hashed the same, so every section should still exist
+            auto section = findSection(sectionId);
+            if (!section) {
+                return false;
+            }
+            TimeSlot timeSlot(duration, static_cast<TimeSlot::Day>(day),
+                              startHour, startMinute);
+            schedule->addSection(section->withTimeSlot(timeSlot));
+        }
+        loaded.schedules.push_back(schedule);
+    }
+
+    if (!file || loaded.schedules.size() != scheduleCount ||
+        loaded.currentIndex >= static_cast<int>(scheduleCount)) {
+        return false;
+    }
+
+    result = loaded;
+    return true;
+}
+
+void SolveCache::writeToDisk(uint64_t key, const CachedSolve& result) const {
+    // Write to a temporary file first so a crash never leaves a half-written entry
+    std::string path = pathFor(key);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            return;
+        }
+
+        file << "SOLVE 1\n";
+        file << (result.found ? 1 : 0) << " " << result.currentIndex << " " << result.schedules.size() << "\n";
+        for (const auto& schedule : result.schedules) {
+            const auto& sections = schedule->getSections();
+            file << sections.size() << "\n";
+            for (const auto& section : sections) {
+                auto timeSlot = section->getTimeSlot();
+                file << static_cast<int>(timeSlot.getDay()) << " " << timeSlot.getStartHour() << " "
+                     << timeSlot.getStartMinute() << " " << timeSlot.getDurationMinutes() << " "
+                     << section->getId() << "\n";
+            }
+        }
+        if (!file) {
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+    std::remove(path.c_str());  // rename does not replace existing files on Windows
+    std::rename(temporary.c_str(), path.c_str());
+}
@@ -0,0 +1,80 @@
+#ifndef SOLVE_CACHE_HPP
+#define SOLVE_CACHE_HPP
+
+#include "Models.hpp"
+#include <vector>
+#include <memory>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+// Stable 64-bit FNV-1a hash of the solver inputs. Every field is followed by a
+// separator so that ("ab", "c") and ("a", "bc") hash differently.
+class Fingerprint {
+public:
+    Fingerprint();
+
+    Fingerprint& add(const std::string& value);
+    Fingerprint& add(long long value);
+    Fingerprint& add(double value);
+
+    uint64_t value() const;
+    std::string toHex() const;
+
+private:
+    uint64_t hash;
+
+    void mix(const void* data, size_t size);
+};
+
+// Result of one solve as it is remembered by the cache
+struct CachedSolve {
+    bool found = false;
+    std::vector<std::shared_ptr<Schedule>> schedules;  // Best first
+    int currentIndex = -1;                              // Index of the current schedule (-1 = none)
+};
+
+// Least recently used cache of solve results keyed by input fingerprint. Entries
+// can also be written to a directory so they survive restarts; those are read
+// back lazily when the in-memory cache misses.
+class SolveCache {
+public:
+    explicit SolveCache(size_t capacity = 16);
+
+    // 0 disables caching altogether
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const;
+
+    // Empty keeps the cache in memory only
+    void setDirectory(const std::string& directory);
+    const std::string& getDirectory() const;
+
+    // Entries are rebuilt against the scheduler's sections: disk entries only store
+    // ids and times, and in memory a section may have been removed and re-added
+    // since the solve (nullptr drops the entry)
+    using SectionLookup = std::function<Ref<Section>(const std::string&)>;
+
+    bool lookup(uint64_t key, const SectionLookup& findSection, CachedSolve& result);
+    void store(uint64_t key, const CachedSolve& result);
+
+    size_t size() const;
+    void clear();
+
+private:
+    using Entry = std::pair<uint64_t, CachedSolve>;
+
+    size_t capacity;
+    std::string directory;
+    std::list<Entry> entries;  // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+    void insert(uint64_t key, const CachedSolve& result);
+    std::string pathFor(uint64_t key) const;
+    static bool rebind(CachedSolve& solve, const SectionLookup& findSection);
+    bool readFromDisk(uint64_t key, const SectionLookup& findSection, CachedSolve& result) const;
+    void writeToDisk(uint64_t key, const CachedSolve& result) const;
+};
+
+#endif // SOLVE_CACHE_HPP
@@ -0,0 +1,58 @@
+#include "SolverStats.hpp"
+#include <sstream>
+#include <iomanip>
+
+constexpr int SolverStats::PHASE_COUNT;
+constexpr int SolverStats::REASON_COUNT;
+
+std::string SolverStats::toString() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "Solve took " << totalNanos / 1e6 << " ms" << (fromCache ? " (cached)" : "") << "\n";
+
+    out << "Phases:\n";
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        out << "  " << std::left << std::setw(18) << phaseName(static_cast<SolvePhase>(i))
+            << std::right << std::setw(12) << phaseNanos[i] / 1e6 << " ms"
+            << std::setw(10) << phaseCalls[i] << " calls\n";
+    }
+
+    out << "Counters:\n"
+        << "  permutations enumerated " << permutationsEnumerated << "\n"
+        << "  packing failures        " << packingFailures << "\n"
+        << "  conflict rejects        " << conflictRejects << "\n"
+        << "  dedupe hits             " << dedupeHits << "\n"
+        << "  requirement failures    " << requirementFailures << "\n";
+
+    out << "Rejections:";
+    for (int i = 0; i < REASON_COUNT; i++) {
+        out << "\n  " << std::left << std::setw(24) << reasonName(static_cast<RejectReason>(i))
+            << std::right << rejections[i];
+    }
+    return out.str();
+}
+
+const char* SolverStats::phaseName(SolvePhase phase) {
+    switch (phase) {
+        case SolvePhase::TREE_BUILD:        return "tree build";
+        case SolvePhase::ENUMERATION:       return "enumeration";
+        case SolvePhase::PACKING:           return "packing";
+        case SolvePhase::CONFLICT_CHECK:    return "conflict check";
+        case SolvePhase::SCORING:           return "scoring";
+        case SolvePhase::DEDUPE:            return "dedupe";
+        case SolvePhase::REQUIREMENT_CHECK: return "requirement check";
+        default:                            return "unknown";
+    }
+}
+
+const char* SolverStats::reasonName(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::UNMAPPED_PERMUTATION:    return "unmapped permutation";
+        case RejectReason::UNREPAIRABLE_PACKING:    return "unrepairable packing";
+        case RejectReason::VARIATION_CONFLICT:      return "variation conflict";
+        case RejectReason::BELOW_CUTOFF:            return "below cutoff";
+        case RejectReason::DUPLICATE:               return "duplicate";
+        case RejectReason::REQUIREMENT_UNSATISFIED: return "requirement unsatisfied";
+        default:                                    return "unknown";
+    }
+}
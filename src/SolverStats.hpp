@@ -0,0 +1,80 @@
+#ifndef SOLVER_STATS_HPP
+#define SOLVER_STATS_HPP
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+enum class SolvePhase {
+    TREE_BUILD,         // Building the time ordered PQ tree
+    ENUMERATION,        // Reading frontiers and mapping them back to sections
+    PACKING,            // Greedy packing plus min-conflicts repair
+    CONFLICT_CHECK,     // Conflict checks of base schedules and variations
+    SCORING,            // Ranking candidates for the retained set
+    DEDUPE,             // Comparing candidates against the retained schedules
+    REQUIREMENT_CHECK,  // Picking the best schedule that satisfies every requirement
+    COUNT
+};
+
+enum class RejectReason {
+    UNMAPPED_PERMUTATION,    // A frontier label did not match any section
+    UNREPAIRABLE_PACKING,    // Packing had conflicts that repair could not remove
+    VARIATION_CONFLICT,      // A moved section collided with the rest of the schedule
+    BELOW_CUTOFF,            // Scored too low to enter the retained set
+    DUPLICATE,               // Equivalent to a schedule already retained
+    REQUIREMENT_UNSATISFIED, // Retained but failed a hard requirement
+    COUNT
+};
+
+// Where the time of the last solve went. Filled by Scheduler::generateSchedule;
+// everything is plain counters, so it stays on in release builds.
+struct SolverStats {
+    static constexpr int PHASE_COUNT = static_cast<int>(SolvePhase::COUNT);
+    static constexpr int REASON_COUNT = static_cast<int>(RejectReason::COUNT);
+
+    int64_t totalNanos = 0;
+    int64_t phaseNanos[PHASE_COUNT] = {};
+    long phaseCalls[PHASE_COUNT] = {};
+
+    long permutationsEnumerated = 0;
+    long packingFailures = 0;      // Packings that needed a repair, successful or not
+    long conflictRejects = 0;
+    long dedupeHits = 0;
+    long requirementFailures = 0;
+    long rejections[REASON_COUNT] = {};
+
+    bool fromCache = false;        // Answered by the solve cache, nothing was timed
+
+    void reject(RejectReason reason) { rejections[static_cast<int>(reason)]++; }
+    long rejected(RejectReason reason) const { return rejections[static_cast<int>(reason)]; }
+    double phaseMs(SolvePhase phase) const { return phaseNanos[static_cast<int>(phase)] / 1e6; }
+
+    // Multi-line human readable report (phases, counters and the rejection histogram)
+    std::string toString() const;
+
+    static const char* phaseName(SolvePhase phase);
+    static const char* reasonName(RejectReason reason);
+};
+
+// Adds the lifetime of the timer to one phase of a SolverStats
+class PhaseTimer {
+public:
+    PhaseTimer(SolverStats& stats, SolvePhase phase)
+        : stats(stats), phase(static_cast<int>(phase)), start(std::chrono::steady_clock::now()) {}
+
+    ~PhaseTimer() {
+        stats.phaseNanos[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        stats.phaseCalls[phase]++;
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    SolverStats& stats;
+    int phase;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // SOLVER_STATS_HPP
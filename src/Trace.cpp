@@ -0,0 +1,190 @@
+#include "Trace.hpp"
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <cstdio>
+
+std::atomic<bool> Tracer::enabled(false);
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    int64_t start;
+    int64_t duration;
+    uint32_t threadId;
+};
+
+// Written by exactly one thread at a time; readers only look at `written`
+struct ThreadBuffer {
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> written;
+    uint32_t threadId;
+
+    explicit ThreadBuffer(size_t capacity) : events(capacity), written(0), threadId(0) {}
+};
+
+// Buffers outlive their threads so finished solver threads still show up in the
+// dump; a new thread takes over a retired buffer instead of allocating another.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> retired;
+    std::map<uint32_t, std::string> threadNames;
+    uint32_t nextThreadId = 1;
+    size_t capacity = 1 << 16;
+};
+
+Registry& registry() {
+    // Never destroyed, threads may still retire their buffers during shutdown
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+struct ThreadSlot {
+    ThreadBuffer* buffer = nullptr;
+    uint32_t threadId = 0;
+
+    ~ThreadSlot() {
+        if (buffer) {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.retired.push_back(buffer);
+        }
+    }
+};
+
+thread_local ThreadSlot slot;
+
+uint32_t currentThreadId() {
+    if (slot.threadId == 0) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        slot.threadId = r.nextThreadId++;
+    }
+    return slot.threadId;
+}
+
+ThreadBuffer* currentBuffer() {
+    if (!slot.buffer) {
+        uint32_t threadId = currentThreadId();
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.retired.empty()) {
+            slot.buffer = r.retired.back();
+            r.retired.pop_back();
+        } else {
+            r.buffers.emplace_back(new ThreadBuffer(r.capacity));
+            slot.buffer = r.buffers.back().get();
+        }
+        slot.buffer->threadId = threadId;
+    }
+    return slot.buffer;
+}
+
+void writeEscaped(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*c));
+            out << escaped;
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+void Tracer::setEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Tracer::setBufferCapacity(size_t events) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.capacity = events > 0 ? events : 1;
+}
+
+void Tracer::setThreadName(const char* name) {
+    uint32_t threadId = currentThreadId();
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threadNames[threadId] = name;
+}
+
+void Tracer::record(const char* name, const char* category, int64_t startNanos, int64_t durationNanos) {
+    ThreadBuffer* buffer = currentBuffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer->events[index % buffer->events.size()];
+    event.name = name;
+    event.category = category;
+    event.start = startNanos;
+    event.duration = durationNanos;
+    event.threadId = buffer->threadId;
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::writeJson(std::ostream& out) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    for (const auto& entry : r.threadNames) {
+        separator();
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << entry.first
+            << ",\"args\":{\"name\":";
+        writeEscaped(out, entry.second.c_str());
+        out << "}}";
+    }
+
+    char timestamp[64];
+    for (const auto& buffer : r.buffers) {
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->events.size();
+        uint64_t begin = written > capacity ? written - capacity : 0;
+        for (uint64_t i = begin; i < written; i++) {
+            const TraceEvent& event = buffer->events[i % capacity];
+            separator();
+            out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId << ",\"name\":";
+            writeEscaped(out, event.name);
+            out << ",\"cat\":";
+            writeEscaped(out, event.category);
+            // Trace viewers expect microseconds
+            std::snprintf(timestamp, sizeof(timestamp), ",\"ts\":%.3f,\"dur\":%.3f}",
+                          event.start / 1000.0, event.duration / 1000.0);
+            out << timestamp;
+        }
+    }
+    out << "\n]}\n";
+}
+
+bool Tracer::writeJsonFile(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    writeJson(file);
+    return static_cast<bool>(file);
+}
+
+void Tracer::clear() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& buffer : r.buffers) {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
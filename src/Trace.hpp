@@ -0,0 +1,81 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <string>
+#include <ostream>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Build with -DSCHEDULER_ENABLE_TRACING=0 to compile every TRACE_SCOPE out
+#ifndef SCHEDULER_ENABLE_TRACING
+#define SCHEDULER_ENABLE_TRACING 1
+#endif
+
+// Opt-in recorder of timed scopes, exported as Chrome trace-event JSON (load the
+// file in chrome://tracing or ui.perfetto.dev). Each thread appends to its own
+// fixed-size ring buffer without taking a lock; when a buffer is full the oldest
+// events are overwritten. While disabled a scope costs one relaxed load.
+class Tracer {
+public:
+    static void setEnabled(bool enable);
+    static bool isEnabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // Events kept per thread (takes effect for buffers created afterwards)
+    static void setBufferCapacity(size_t events);
+
+    // Label the calling thread in the trace viewer
+    static void setThreadName(const char* name);
+
+    // Name and category must be string literals, only the pointers are stored
+    static void record(const char* name, const char* category, int64_t startNanos, int64_t durationNanos);
+
+    static int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Best taken once the traced threads are idle; events written concurrently may be torn
+    static void writeJson(std::ostream& out);
+    static bool writeJsonFile(const std::string& path);
+
+    // Drop every recorded event
+    static void clear();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+// Records the lifetime of the enclosing block as one complete ("X") event
+class TraceScope {
+public:
+    TraceScope(const char* name, const char* category)
+        : name(name), category(category), start(Tracer::isEnabled() ? Tracer::nowNanos() : -1) {}
+
+    ~TraceScope() {
+        if (start >= 0) {
+            Tracer::record(name, category, start, Tracer::nowNanos() - start);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    int64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if SCHEDULER_ENABLE_TRACING
+#define TRACE_SCOPE(name, category) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, category)
+#else
+#define TRACE_SCOPE(name, category) do {} while (0)
+#endif
+
+#endif // TRACE_HPP
@@ -1,8 +1,9 @@
 #include "UI.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
 #include <cmath>
 #include <algorithm>
 #include <sstream>
-#include <iostream>
 #include <cstring>  // For strcpy and strlen
 #include <cstdio>   // For sprintf
 
@@ -297,27 +298,55 @@ void UI::initialize() {
     InitWindow(screenWidth, screenHeight, windowTitle);
     SetTargetFPS(60);
     
-    // Add some dummy data for testing
-    addDummyData();
+    // Pick up where the last session left off, or add some dummy data for testing.
+    // When the journal cannot be opened, keep whatever was restored and leave the
+    // files alone so nothing on disk is lost.
+    std::string error;
+    if (!snapshotPath.empty() && !journal.open(snapshotPath, snapshotPath + ".journal", *scheduler, error)) {
+        SLOG_ERROR("ui", "Edits will not be saved: " << error);
+        journalWarning = "Edits will not be saved: " + error;
+    } else if (scheduler->getCourses().empty()) {
+        addDummyData();
+    }
     
     // Create initial screen
     changeScreen(ScreenState::MAIN_MENU);
 }
 
+void UI::setSnapshotPath(const std::string& path) {
+    snapshotPath = path;
+}
+
 void UI::run() {
     while (!WindowShouldClose() && isRunning) {
-        // Update and draw the current screen
-        currentScreen->update();
-        
-        BeginDrawing();
-        ClearBackground(RAYWHITE);
+        TRACE_SCOPE("frame", "ui");
         
-        currentScreen->draw();
+        // Update and draw the current screen
+        {
+            TRACE_SCOPE("update", "ui");
+            currentScreen->update();
+        }
         
-        EndDrawing();
+        {
+            TRACE_SCOPE("draw", "ui");
+            BeginDrawing();
+            ClearBackground(RAYWHITE);
+            
+            currentScreen->draw();
+            if (!journalWarning.empty()) {
+                DrawRectangle(0, screenHeight - 24, screenWidth, 24, MAROON);
+                DrawText(journalWarning.c_str(), 10, screenHeight - 20, 16, WHITE);
+            }
+            
+            EndDrawing();
+        }
         
         // Process input and potentially change screens
-        ScreenState newState = currentScreen->processInput();
+        ScreenState newState;
+        {
+            TRACE_SCOPE("processInput", "ui");
+            newState = currentScreen->processInput();
+        }
         if (newState != currentState) {
             // Save current schedule index before changing screens
             if (currentState == ScreenState::SCHEDULE_VIEWER || currentState == ScreenState::PQ_TREE_VIEWER) {
@@ -327,6 +356,18 @@ void UI::run() {
             changeScreen(newState);
         }
     }
+
+    // Dropping the screen cancels and joins a solve still running, so the snapshot
+    // below does not read schedules the solver is writing
+    currentScreen.reset();
+
+    if (journal.isOpen()) {
+        std::string error;
+        if (!journal.compact(error)) {
+            SLOG_ERROR("ui", "Could not save snapshot, edits stay in the journal: " << error);
+        }
+        journal.close();
+    }
     
     // Clean up
     CloseWindow();
@@ -635,7 +676,7 @@ void CourseManagementScreen::addCourse() {
         return;
     }
     
-    auto course = std::make_shared<Course>(code, name, credits);
+    auto course = makeRef<Course>(code, name, credits);
     scheduler->addCourse(course);
     
     // Clear the input fields
@@ -834,7 +875,7 @@ void TeacherManagementScreen::addTeacher() {
         return;
     }
     
-    auto teacher = std::make_shared<Teacher>(id, name);
+    auto teacher = makeRef<Teacher>(id, name);
     scheduler->addTeacher(teacher);
     
     // Clear the input fields
@@ -861,16 +902,13 @@ void TeacherManagementScreen::assignCourseToTeacher() {
     std::string courseCode = selectedCourseOption.substr(0, selectedCourseOption.find(" - "));
     
     // Find the course with this code
-    for (const auto& course : scheduler->getCourses()) {
-        if (course->getCode() == courseCode) {
-            // Add the course to the teacher
-            auto teacher = displayedTeachers[selectedTeacherIndex];
-            teacher->addCourse(course);
-            
-            // Refresh the display
-            refreshTeacherList();
-            break;
-        }
+    if (auto course = scheduler->findCourse(courseCode)) {
+        // Add the course to the teacher
+        auto teacher = displayedTeachers[selectedTeacherIndex];
+        scheduler->assignCourse(teacher, course);
+        
+        // Refresh the display
+        refreshTeacherList();
     }
 }
 
@@ -993,8 +1031,8 @@ void SectionManagementScreen::draw() {
                  detailX, detailY + 60, 20, DARKGRAY);
         
         // Display time information - either just day and duration or full time if scheduled
-        std::string timeInfo = "Time: " + timeSlot->toString();
-        if (!timeSlot->hasStartTime()) {
+        std::string timeInfo = "Time: " + timeSlot.toString();
+        if (!timeSlot.hasStartTime()) {
             timeInfo += " (Start time will be assigned during scheduling)";
         }
         
@@ -1092,13 +1130,7 @@ void SectionManagementScreen::addSection() {
     
     // Find the selected course
     std::string courseCode = courseOption.substr(0, courseOption.find(" - "));
-    std::shared_ptr<Course> selectedCourse;
-    for (const auto& course : scheduler->getCourses()) {
-        if (course->getCode() == courseCode) {
-            selectedCourse = course;
-            break;
-        }
-    }
+    Ref<Course> selectedCourse = scheduler->findCourse(courseCode);
     
     if (!selectedCourse) {
         return;
@@ -1106,23 +1138,17 @@ void SectionManagementScreen::addSection() {
     
     // Find the selected teacher
     std::string teacherId = teacherOption.substr(0, teacherOption.find(" - "));
-    std::shared_ptr<Teacher> selectedTeacher;
-    for (const auto& teacher : scheduler->getTeachers()) {
-        if (teacher->getId() == teacherId) {
-            selectedTeacher = teacher;
-            break;
-        }
-    }
+    Ref<Teacher> selectedTeacher = scheduler->findTeacher(teacherId);
     
     if (!selectedTeacher) {
         return;
     }
     
     // Create TimeSlot (only with duration - day and start time will be assigned by scheduler)
-    auto timeSlot = std::make_shared<TimeSlot>(duration);
+    TimeSlot timeSlot(duration);
     
     // Create Section
-    auto section = std::make_shared<Section>(id, selectedCourse, selectedTeacher, timeSlot);
+    auto section = makeRef<Section>(id, selectedCourse, selectedTeacher, timeSlot);
     
     // Add Section to scheduler
     scheduler->addSection(section);
@@ -1308,18 +1334,11 @@ void RequirementManagementScreen::addRequirement() {
     // Extract the section ID from the option string
     std::string sectionId = sectionOption.substr(0, sectionOption.find(" - "));
     
-    // Find the section with this ID directly from the scheduler's sections
-    // to ensure we're using the same object reference
-    std::shared_ptr<Section> selectedSection = nullptr;
-    for (const auto& section : scheduler->getSections()) {
-        if (section->getId() == sectionId) {
-            selectedSection = section;
-            break;
-        }
-    }
+    // Look the section up in the scheduler to ensure we're using the same object reference
+    Ref<Section> selectedSection = scheduler->findSection(sectionId);
     
     if (!selectedSection) {
-        std::cout << "ERROR: Section not found!" << std::endl;
+        SLOG_ERROR("ui", "Section " << sectionId << " not found");
         return;
     }
     
@@ -1329,7 +1348,7 @@ void RequirementManagementScreen::addRequirement() {
     std::string startMinuteStr = startMinuteInput->getText();
     
     // Get the duration from the section's existing timeSlot
-    int duration = selectedSection->getTimeSlot()->getDurationMinutes();
+    int duration = selectedSection->getTimeSlot().getDurationMinutes();
     
     // Parse time values
     int startHour = -1, startMinute = -1;
@@ -1343,11 +1362,11 @@ void RequirementManagementScreen::addRequirement() {
             // Validate time values
             if (startHour < 0 || startHour > 23 || 
                 startMinute < 0 || startMinute > 59) {
-                std::cout << "ERROR: Invalid time values!" << std::endl;
+                SLOG_WARN("ui", "Invalid time values " << startHour << ":" << startMinute);
                 return;
             }
         } catch (const std::exception&) {
-            std::cout << "ERROR: Failed to parse time values!" << std::endl;
+            SLOG_WARN("ui", "Failed to parse time values");
             return;
         }
     }
@@ -1360,7 +1379,7 @@ void RequirementManagementScreen::addRequirement() {
     else if (dayOption == "Thursday") day = TimeSlot::THURSDAY;
     else day = TimeSlot::FRIDAY;
     
-    auto timeSlot = std::make_shared<TimeSlot>(duration, day, startHour, startMinute);
+    TimeSlot timeSlot(duration, day, startHour, startMinute);
     
     // Create SectionTimeSlotRequirement
     auto requirement = std::make_shared<SectionTimeSlotRequirement>(selectedSection, timeSlot);
@@ -1394,7 +1413,16 @@ void RequirementManagementScreen::deleteRequirement(size_t index) {
 
 // ScheduleViewerScreen implementation
 ScheduleViewerScreen::ScheduleViewerScreen(std::shared_ptr<Scheduler> scheduler)
-    : Screen(scheduler), currentScheduleIndex(0) {}
+    : Screen(scheduler), currentScheduleIndex(0), solving(false), solveFinished(false),
+      leaveWhenDone(false) {}
+
+ScheduleViewerScreen::~ScheduleViewerScreen() {
+    // The solver checks the token often, so this join is short
+    cancelSolve();
+    if (solverThread.joinable()) {
+        solverThread.join();
+    }
+}
 
 void ScheduleViewerScreen::initialize() {
     // Create a back button
@@ -1444,10 +1472,18 @@ void ScheduleViewerScreen::initialize() {
         // Will show PQ tree in processInput
     });
     components.push_back(std::move(viewPQTreeButton));
+    
+    // Only shown while a solve is running
+    cancelButton = std::unique_ptr<Button>(new Button(
+        720, 20, 120, 40, "Cancel", RED
+    ));
+    cancelButton->setOnClick([this]() {
+        cancelSolve();
+    });
 }
 
 void ScheduleViewerScreen::update() {
-    // Nothing to update continuously
+    pollSolve();
 }
 
 void ScheduleViewerScreen::draw() {
@@ -1458,8 +1494,15 @@ void ScheduleViewerScreen::draw() {
         component->draw();
     }
     
+    if (solving) {
+        cancelButton->draw();
+        drawProgressBar();
+    }
+    
     // Draw placeholder text or schedule
-    if (displayedSchedules.empty()) {
+    if (displayedSchedules.empty() && solving) {
+        DrawText("Searching for schedules...", 200, 300, 20, GRAY);
+    } else if (displayedSchedules.empty()) {
         DrawText("No schedules generated yet. Press 'Generate' to create schedules.", 200, 300, 20, GRAY);
     } else {
         // Display current schedule index information
@@ -1471,11 +1514,25 @@ void ScheduleViewerScreen::draw() {
 }
 
 ScreenState ScheduleViewerScreen::processInput() {
+    if (solving) {
+        cancelButton->handleInput();
+    }
+    
+    // Leaving mid-solve cancels it; we switch screens once the worker is done
+    if (leaveWhenDone && !solving) {
+        return ScreenState::MAIN_MENU;
+    }
+    
     // Check each component for input
     for (size_t i = 0; i < components.size(); i++) {
         if (components[i]->handleInput()) {
             // If the back button was clicked
             if (i == 0) {
+                if (solving) {
+                    cancelSolve();
+                    leaveWhenDone = true;
+                    return ScreenState::SCHEDULE_VIEWER;
+                }
                 return ScreenState::MAIN_MENU;
             }
             // If the Generate button was clicked
@@ -1493,7 +1550,7 @@ ScreenState ScheduleViewerScreen::processInput() {
                 // Do not update currentScheduleIndex again here
             }
             // If the View PQ Tree button was clicked
-            else if (i == 4 && !displayedSchedules.empty()) {
+            else if (i == 4 && !solving && !displayedSchedules.empty()) {
                 return ScreenState::PQ_TREE_VIEWER;
             }
         }
@@ -1502,10 +1559,102 @@ ScreenState ScheduleViewerScreen::processInput() {
 }
 
 void ScheduleViewerScreen::generateSchedules() {
-    // Generate schedules using the scheduler
-    scheduler->generateSchedule();
-    displayedSchedules = scheduler->getAllPossibleSchedules();
+    if (solving) {
+        return;
+    }
+    if (solverThread.joinable()) {
+        solverThread.join();
+    }
+    
+    displayedSchedules.clear();
     currentScheduleIndex = 0;
+    pendingSchedules.clear();
+    latestProgress = SolveProgress();
+    cancelToken = std::make_shared<std::atomic<bool>>(false);
+    
+    // Schedules and progress are handed over under the mutex and picked up in update()
+    SolveOptions options;
+    options.cancel = cancelToken;
+    options.onSchedule = [this](std::shared_ptr<Schedule> schedule) {
+        std::lock_guard<std::mutex> lock(solveMutex);
+        pendingSchedules.push_back(schedule);
+    };
+    options.onProgress = [this](const SolveProgress& progress) {
+        std::lock_guard<std::mutex> lock(solveMutex);
+        latestProgress = progress;
+    };
+    
+    // The other screens are not reachable while solving, so the scheduler is not edited meanwhile.
+    // A single added or pinned section since the last solve is repaired in place.
+    solving = true;
+    solveFinished = false;
+    solverThread = std::thread([this, options]() {
+        Tracer::setThreadName("solver");
+        scheduler->resolveAfterEdits(options);
+        solveFinished = true;
+    });
+}
+
+void ScheduleViewerScreen::cancelSolve() {
+    if (cancelToken) {
+        cancelToken->store(true);
+    }
+}
+
+void ScheduleViewerScreen::pollSolve() {
+    if (!solving) {
+        return;
+    }
+    
+    // Stream in what was found since the last frame
+    {
+        std::lock_guard<std::mutex> lock(solveMutex);
+        displayedSchedules.insert(displayedSchedules.end(), pendingSchedules.begin(), pendingSchedules.end());
+        pendingSchedules.clear();
+    }
+    
+    if (solveFinished) {
+        // The worker has returned, so joining does not wait
+        solverThread.join();
+        solving = false;
+        
+        // Replace the streamed list with the final ranking (best first)
+        displayedSchedules = scheduler->getAllPossibleSchedules();
+        currentScheduleIndex = 0;
+    }
+}
+
+void ScheduleViewerScreen::drawProgressBar() {
+    SolveProgress progress;
+    {
+        std::lock_guard<std::mutex> lock(solveMutex);
+        progress = latestProgress;
+    }
+    
+    const int barX = 860;
+    const int barY = 25;
+    const int barWidth = 380;
+    const int barHeight = 30;
+    
+    DrawRectangle(barX, barY, barWidth, barHeight, LIGHTGRAY);
+    if (progress.candidatesTotal > 0) {
+        float fraction = std::min(1.0f, static_cast<float>(progress.candidatesTried) / progress.candidatesTotal);
+        DrawRectangle(barX, barY, static_cast<int>(barWidth * fraction), barHeight, GREEN);
+    } else {
+        // Unknown total: sweep a block back and forth
+        int blockWidth = barWidth / 5;
+        float phase = std::fmod(static_cast<float>(GetTime()), 2.0f);
+        float position = phase < 1.0f ? phase : 2.0f - phase;
+        DrawRectangle(barX + static_cast<int>((barWidth - blockWidth) * position), barY, blockWidth, barHeight, GREEN);
+    }
+    DrawRectangleLines(barX, barY, barWidth, barHeight, DARKGRAY);
+    
+    std::string status = std::to_string(progress.candidatesTried) + " tried, " +
+                         std::to_string(progress.validFound) + " valid";
+    if (cancelToken && cancelToken->load()) {
+        status = "Cancelling... " + status;
+    }
+    DrawText(status.c_str(), barX, barY + barHeight + 5, 16, DARKGRAY);
 }
 
 void ScheduleViewerScreen::drawScheduleGrid() {
@@ -1571,7 +1720,7 @@ void ScheduleViewerScreen::drawScheduleGrid() {
     }
     
     // Group sections by course for better visualization
-    std::map<std::string, std::vector<std::shared_ptr<Section>>> sectionsByCourse;
+    std::map<std::string, std::vector<Ref<Section>>> sectionsByCourse;
     
     // Draw classes on the grid - Make sure we're using the current schedule index
     auto schedule = displayedSchedules[currentScheduleIndex];
@@ -1612,19 +1761,19 @@ void ScheduleViewerScreen::drawScheduleGrid() {
         
         for (const auto& section : courseSections) {
             auto timeSlot = section->getTimeSlot();
-            auto startTime = timeSlot->getStartHour() * 60 + timeSlot->getStartMinute();
-            auto duration = timeSlot->getDurationMinutes();
-            auto day = timeSlot->getDay();
+            auto startTime = timeSlot.getStartHour() * 60 + timeSlot.getStartMinute();
+            auto duration = timeSlot.getDurationMinutes();
+            auto day = timeSlot.getDay();
             
             // Skip if outside our grid
-            if (timeSlot->getStartHour() < 8 || timeSlot->getStartHour() >= 17 || day > TimeSlot::FRIDAY) {
+            if (timeSlot.getStartHour() < 8 || timeSlot.getStartHour() >= 17 || day > TimeSlot::FRIDAY) {
                 continue;
             }
             
             // Calculate position in grid
             int dayIndex = static_cast<int>(day);
-            int startHour = timeSlot->getStartHour();
-            int startMin = timeSlot->getStartMinute();
+            int startHour = timeSlot.getStartHour();
+            int startMin = timeSlot.getStartMinute();
             int startRowIndex = startHour - 8; // Grid starts at 8AM
             
             // Calculate fractional positioning for better precision
@@ -1639,8 +1788,8 @@ void ScheduleViewerScreen::drawScheduleGrid() {
             for (const auto& req : scheduler->getRequirements()) {
                 auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(req);
                 if (sectionReq) {
-                    // Use section ID comparison rather than pointer equality
-                    if (sectionReq->getSection()->getId() == section->getId()) {
+                    // The drawn section is a placed copy, so compare identity rather than pointers
+                    if (sectionReq->getSection()->isSameAs(*section)) {
                         hasRequirement = true;
                         break;
                     }
@@ -1920,7 +2069,7 @@ void PQTreeViewerScreen::drawPQTree() {
     drawNode(root, rootPos, zoomLevel);
 }
 
-void PQTreeViewerScreen::drawNode(std::shared_ptr<PQNode> node, Vector2 position, float scale) {
+void PQTreeViewerScreen::drawNode(Ref<PQNode> node, Vector2 position, float scale) {
     if (!node) return;
     
     // Different colors for different node types
@@ -1998,20 +2147,20 @@ void PQTreeViewerScreen::drawNode(std::shared_ptr<PQNode> node, Vector2 position
 // New method to add dummy data
 void UI::addDummyData() {
     // Create courses for Math, Computer, and English
-    auto mathCourse = std::make_shared<Course>("MATH101", "Mathematics", 3);
-    auto compCourse = std::make_shared<Course>("COMP101", "Computer Science", 3);
-    auto engCourse = std::make_shared<Course>("ENG101", "English", 3);
+    auto mathCourse = makeRef<Course>("MATH101", "Mathematics", 3);
+    auto compCourse = makeRef<Course>("COMP101", "Computer Science", 3);
+    auto engCourse = makeRef<Course>("ENG101", "English", 3);
     
     scheduler->addCourse(mathCourse);
     scheduler->addCourse(compCourse);
     scheduler->addCourse(engCourse);
     
     // Create teachers
-    auto maria = std::make_shared<Teacher>("T001", "Miss Maria");
-    auto qasim = std::make_shared<Teacher>("T002", "Sir Qasim");
-    auto salman = std::make_shared<Teacher>("T003", "Sir Salman");
-    auto hamna = std::make_shared<Teacher>("T004", "Miss Hamna");
-    auto sara = std::make_shared<Teacher>("T005", "Miss Sara");
+    auto maria = makeRef<Teacher>("T001", "Miss Maria");
+    auto qasim = makeRef<Teacher>("T002", "Sir Qasim");
+    auto salman = makeRef<Teacher>("T003", "Sir Salman");
+    auto hamna = makeRef<Teacher>("T004", "Miss Hamna");
+    auto sara = makeRef<Teacher>("T005", "Miss Sara");
     
     scheduler->addTeacher(maria);
     scheduler->addTeacher(qasim);
@@ -2022,25 +2171,25 @@ void UI::addDummyData() {
     // Create sections with only duration - day and start time will be dynamically assigned
     
     // Math sections
-    auto mathTimeSlot1 = std::make_shared<TimeSlot>(60); // 60 min duration
-    auto mathSection1 = std::make_shared<Section>("MATH101-A", mathCourse, maria, mathTimeSlot1);
+    TimeSlot mathTimeSlot1(60); // 60 min duration
+    auto mathSection1 = makeRef<Section>("MATH101-A", mathCourse, maria, mathTimeSlot1);
     
-    auto mathTimeSlot2 = std::make_shared<TimeSlot>(60); // 60 min duration
-    auto mathSection2 = std::make_shared<Section>("MATH101-B", mathCourse, qasim, mathTimeSlot2);
+    TimeSlot mathTimeSlot2(60); // 60 min duration
+    auto mathSection2 = makeRef<Section>("MATH101-B", mathCourse, qasim, mathTimeSlot2);
     
     // Computer sections
-    auto compTimeSlot1 = std::make_shared<TimeSlot>(90); // 90 min duration
-    auto compSection1 = std::make_shared<Section>("COMP101-A", compCourse, salman, compTimeSlot1);
+    TimeSlot compTimeSlot1(90); // 90 min duration
+    auto compSection1 = makeRef<Section>("COMP101-A", compCourse, salman, compTimeSlot1);
     
-    auto compTimeSlot2 = std::make_shared<TimeSlot>(90); // 90 min duration
-    auto compSection2 = std::make_shared<Section>("COMP101-B", compCourse, maria, compTimeSlot2);
+    TimeSlot compTimeSlot2(90); // 90 min duration
+    auto compSection2 = makeRef<Section>("COMP101-B", compCourse, maria, compTimeSlot2);
     
     // English sections
-    auto engTimeSlot1 = std::make_shared<TimeSlot>(75); // 75 min duration
-    auto engSection1 = std::make_shared<Section>("ENG101-A", engCourse, hamna, engTimeSlot1);
+    TimeSlot engTimeSlot1(75); // 75 min duration
+    auto engSection1 = makeRef<Section>("ENG101-A", engCourse, hamna, engTimeSlot1);
     
-    auto engTimeSlot2 = std::make_shared<TimeSlot>(75); // 75 min duration
-    auto engSection2 = std::make_shared<Section>("ENG101-B", engCourse, sara, engTimeSlot2);
+    TimeSlot engTimeSlot2(75); // 75 min duration
+    auto engSection2 = makeRef<Section>("ENG101-B", engCourse, sara, engTimeSlot2);
     
     // Add all sections to the scheduler
     scheduler->addSection(mathSection1);
@@ -2052,22 +2201,20 @@ void UI::addDummyData() {
     
     // Add requirements that specific sections should be at specific times
     auto compSectionReq = std::make_shared<SectionTimeSlotRequirement>(compSection1, 
-        std::make_shared<TimeSlot>(compSection1->getTimeSlot()->getDurationMinutes(), TimeSlot::MONDAY, 9, 0));  // COMP101-A on Monday at 9:00
+        TimeSlot(compSection1->getTimeSlot().getDurationMinutes(), TimeSlot::MONDAY, 9, 0));  // COMP101-A on Monday at 9:00
     auto mathSectionReq = std::make_shared<SectionTimeSlotRequirement>(mathSection1, 
-        std::make_shared<TimeSlot>(mathSection1->getTimeSlot()->getDurationMinutes(), TimeSlot::WEDNESDAY, 13, 0));  // MATH101-A on Wednesday at 13:00
+        TimeSlot(mathSection1->getTimeSlot().getDurationMinutes(), TimeSlot::WEDNESDAY, 13, 0));  // MATH101-A on Wednesday at 13:00
     
     scheduler->addRequirement(compSectionReq);
     // scheduler->addRequirement(mathSectionReq);
     
-    // Print initial requirements
-    std::cout << "=== INITIAL REQUIREMENTS ===" << std::endl;
+    // Initial requirements (opt-in trace output)
     for (const auto& req : scheduler->getRequirements()) {
         auto sectionReq = std::dynamic_pointer_cast<SectionTimeSlotRequirement>(req);
         if (sectionReq) {
-            std::cout << "Requirement: " << req->getDescription() << std::endl;
-            std::cout << "  Section ID: " << sectionReq->getSection()->getId() << std::endl;
-            std::cout << "  Section address: " << sectionReq->getSection().get() << std::endl;
+            SLOG_TRACE("ui", "Initial requirement: " << req->getDescription()
+                      << " (section " << sectionReq->getSection()->getId()
+                      << " at " << sectionReq->getSection().get() << ")");
         }
     }
-    std::cout << "==========================" << std::endl;
 } 
\ No newline at end of file
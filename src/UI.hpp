@@ -1,19 +1,19 @@
 #ifndef UI_HPP
 #define UI_HPP
 
-#include "..\raylib\include\raylib.h" // windows
-// #include "/usr/local/opt/raylib/include/raylib.h" // macos
-// #include "/opt/homebrew/include/raylib.h" // macos
-
-
-// #include "../raylib/include/raylib.h"
+// Found through the include path (-I./raylib/include, or the Homebrew prefix on macOS)
+#include "raylib.h"
 
 #include "Scheduler.hpp"
 #include "PQTree.hpp"
+#include "EditJournal.hpp"
 #include <memory>
 #include <string>
 #include <vector>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
 
 // Forward declarations
 class Screen;
@@ -130,12 +130,19 @@ public:
     void initialize();
     void run();
     
+    // Start from this snapshot plus its edit journal (<path>.journal) and record
+    // every edit there; the journal is folded into the snapshot on exit
+    void setSnapshotPath(const std::string& path);
+    
 private:
     bool isRunning;
     ScreenState currentState;
     std::shared_ptr<Scheduler> scheduler;
     std::unique_ptr<Screen> currentScreen;
     int currentScheduleIndex; // Store the current schedule index across screens
+    std::string snapshotPath;
+    EditJournal journal;
+    std::string journalWarning;  // Shown on every screen when edits are not being recorded
     
     // Window properties
     const int screenWidth = 1280;
@@ -172,7 +179,7 @@ public:
     ScreenState processInput() override;
     
 private:
-    std::vector<std::shared_ptr<Course>> displayedCourses;
+    std::vector<Ref<Course>> displayedCourses;
     int selectedCourseIndex;
     TextInput* codeInput;
     TextInput* nameInput;
@@ -192,7 +199,7 @@ public:
     ScreenState processInput() override;
     
 private:
-    std::vector<std::shared_ptr<Teacher>> displayedTeachers;
+    std::vector<Ref<Teacher>> displayedTeachers;
     int selectedTeacherIndex;
     TextInput* idInput;
     TextInput* nameInput;
@@ -214,7 +221,7 @@ public:
     ScreenState processInput() override;
     
 private:
-    std::vector<std::shared_ptr<Section>> displayedSections;
+    std::vector<Ref<Section>> displayedSections;
     int selectedSectionIndex;
     TextInput* idInput;
     Dropdown* courseDropdown;
@@ -252,6 +259,7 @@ private:
 class ScheduleViewerScreen : public Screen {
 public:
     ScheduleViewerScreen(std::shared_ptr<Scheduler> scheduler);
+    ~ScheduleViewerScreen() override;
     
     void initialize() override;
     void update() override;
@@ -266,7 +274,23 @@ private:
     std::vector<std::shared_ptr<Schedule>> displayedSchedules;
     int currentScheduleIndex;
     
+    // Background solve (the render thread only polls, it never waits on the solver)
+    std::thread solverThread;
+    std::atomic<bool> solving;
+    std::atomic<bool> solveFinished;
+    std::shared_ptr<std::atomic<bool>> cancelToken;
+    std::unique_ptr<Button> cancelButton;
+    bool leaveWhenDone;
+    
+    // Written by the solver thread, drained by the render thread
+    std::mutex solveMutex;
+    std::vector<std::shared_ptr<Schedule>> pendingSchedules;
+    SolveProgress latestProgress;
+    
     void generateSchedules();
+    void cancelSolve();
+    void pollSolve();
+    void drawProgressBar();
     void drawScheduleGrid();
     void drawSelectedSchedule();
 };
@@ -292,7 +316,7 @@ private:
     int currentScheduleIndex; // New member to track current schedule
     
     void drawPQTree();
-    void drawNode(std::shared_ptr<PQNode> node, Vector2 position, float scale);
+    void drawNode(Ref<PQNode> node, Vector2 position, float scale);
 };
 
 #endif // UI_HPP 
\ No newline at end of file
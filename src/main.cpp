@@ -1,16 +1,42 @@
 #include <iostream>
 #include <memory>
+#include <cstdlib>
 #include "UI.hpp"
+#include "Log.hpp"
+#include "Trace.hpp"
 
 int main() {
+    // SCHEDULER_LOG_LEVEL=trace brings back the per-schedule dumps
+    LogLevel level;
+    const char* levelName = std::getenv("SCHEDULER_LOG_LEVEL");
+    if (levelName && Logger::parseLevel(levelName, level)) {
+        Logger::setLevel(level);
+    }
+    
+    // SCHEDULER_TRACE=trace.json records solver and frame timelines for chrome://tracing
+    const char* tracePath = std::getenv("SCHEDULER_TRACE");
+    if (tracePath) {
+        Tracer::setThreadName("main");
+        Tracer::setEnabled(true);
+    }
+    
     try {
         // Create and initialize the UI
         UI ui;
+        
+        // SCHEDULER_SNAPSHOT=term.snap restores the last session and journals every edit
+        const char* snapshotPath = std::getenv("SCHEDULER_SNAPSHOT");
+        if (snapshotPath) {
+            ui.setSnapshotPath(snapshotPath);
+        }
         ui.initialize();
         
         // Run the main loop
         ui.run();
         
+        if (tracePath && !Tracer::writeJsonFile(tracePath)) {
+            std::cerr << "Error: could not write trace to " << tracePath << std::endl;
+        }
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;